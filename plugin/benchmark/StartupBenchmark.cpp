@@ -0,0 +1,87 @@
+// StartupBenchmark.cpp
+// Creates many instances one after another, as a host opening a large template does, and times
+// each stage of their startup: processor construction, prepareToPlay, the first processBlock,
+// editor construction and the editor's first paint. Prints the minimum, median and maximum of
+// every stage over all instances. Instances stay alive until the end, so later ones find the
+// shared resources already set up as they would in a session.
+//
+// Usage: StartupBenchmark [instances]
+#include "MultibandReverb/PluginProcessor.h"
+#include <JuceHeader.h>
+
+namespace {
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 512;
+constexpr int defaultInstances = 40;
+
+enum Stage : size_t { Construction, Prepare, FirstBlock, EditorConstruction, FirstPaint, numStages };
+constexpr const char *stageNames[numStages] = {"Construction", "prepareToPlay", "First processBlock", "Editor construction", "First paint"};
+
+template <typename Fn> double timeMilliseconds(Fn &&fn) {
+    const auto start = juce::Time::getHighResolutionTicks();
+    fn();
+    return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+}
+
+void report(const char *stage, std::vector<double> times) {
+    std::sort(times.begin(), times.end());
+
+    const auto n = times.size();
+    const auto median = n % 2 == 1 ? times[n / 2] : 0.5 * (times[n / 2 - 1] + times[n / 2]);
+    std::printf("%-20s min %9.3f ms   median %9.3f ms   max %9.3f ms\n", stage, times.front(), median, times.back());
+}
+} // namespace
+
+//==============================================================================
+int main(int argc, char *argv[]) {
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const auto numInstances = argc > 1 ? juce::jmax(1, juce::String(argv[1]).getIntValue()) : defaultInstances;
+
+    std::array<std::vector<double>, numStages> times;
+    std::vector<std::unique_ptr<MultibandReverbAudioProcessor>> processors;
+    std::vector<std::unique_ptr<juce::AudioProcessorEditor>> editors;
+    juce::Random random(1);
+    juce::MidiBuffer midi;
+
+    for (int instance = 0; instance < numInstances; ++instance) {
+        std::unique_ptr<MultibandReverbAudioProcessor> processor;
+        times[Construction].push_back(timeMilliseconds([&] { processor = std::make_unique<MultibandReverbAudioProcessor>(); }));
+
+        times[Prepare].push_back(timeMilliseconds([&] {
+            processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+            processor->prepareToPlay(sampleRate, blockSize);
+        }));
+
+        juce::AudioBuffer<float> buffer(juce::jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels()), blockSize);
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+            for (int i = 0; i < blockSize; ++i)
+                buffer.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+        times[FirstBlock].push_back(timeMilliseconds([&] { processor->processBlock(buffer, midi); }));
+
+        std::unique_ptr<juce::AudioProcessorEditor> editor;
+        times[EditorConstruction].push_back(timeMilliseconds([&] { editor.reset(processor->createEditor()); }));
+
+        // Everything the editor's window would draw the first time it is shown
+        juce::Image image(juce::Image::ARGB, juce::jmax(1, editor->getWidth()), juce::jmax(1, editor->getHeight()), true);
+        times[FirstPaint].push_back(timeMilliseconds([&] {
+            juce::Graphics g(image);
+            editor->paintEntireComponent(g, true);
+        }));
+
+        processors.push_back(std::move(processor));
+        editors.push_back(std::move(editor));
+    }
+
+    std::printf("%d instances, stereo at %.0f Hz in blocks of %d\n", numInstances, sampleRate, blockSize);
+    for (size_t stage = 0; stage < numStages; ++stage)
+        report(stageNames[stage], times[stage]);
+
+    // Editors go before the processors they belong to
+    editors.clear();
+    for (auto &processor : processors)
+        processor->releaseResources();
+    processors.clear();
+
+    return 0;
+}
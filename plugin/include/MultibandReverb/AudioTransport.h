@@ -1,14 +1,18 @@
 // AudioTransport.h
 #pragma once
+#include "TransportEngine.h"
+#include "WaveformView.h"
 #include <JuceHeader.h>
 
+// Load/play/stop buttons and a scrubbable waveform of the loaded file for the processor's TransportEngine. Created by
+// the editor, so nothing here exists while no editor is open.
 class AudioTransportComponent : public juce::Component, public juce::Timer, public juce::ChangeListener {
   public:
-    AudioTransportComponent() {
+    explicit AudioTransportComponent(TransportEngine &engineToUse) : engine(engineToUse) {
         addAndMakeVisible(loadButton);
         addAndMakeVisible(playButton);
         addAndMakeVisible(stopButton);
-        addAndMakeVisible(positionSlider);
+        addAndMakeVisible(waveform);
 
         loadButton.setButtonText("Load File");
         playButton.setButtonText("Play");
@@ -18,23 +22,23 @@ class AudioTransportComponent : public juce::Component, public juce::Timer, publ
         playButton.onClick = [this] { playButtonClicked(); };
         stopButton.onClick = [this] { stopButtonClicked(); };
 
-        positionSlider.setRange(0.0, 1.0);
-        positionSlider.onValueChange = [this] {
-            if (formatManager.getNumKnownFormats() > 0 && transportSource.isPlaying()) {
-                const double position = positionSlider.getValue() * transportSource.getLengthInSeconds();
-                transportSource.setPosition(position);
-            }
+        waveform.onScrub = [this](double proportion) {
+            if (engine.hasFile())
+                engine.setPosition(proportion * engine.getLengthInSeconds());
         };
 
-        formatManager.registerBasicFormats();
-        transportSource.addChangeListener(this);
-        startTimer(20); // Update slider 50 times per second
+        // The engine outlives the editor, show a file loaded before it opened
+        if (engine.hasFile())
+            waveform.setFile(engine.getFile());
+
+        engine.addChangeListener(this);
+        updatePlayButtonText();
+        startTimer(20); // Update playhead 50 times per second
     }
 
     ~AudioTransportComponent() override {
         stopTimer();
-        transportSource.setSource(nullptr);
-        transportSource.removeChangeListener(this);
+        engine.removeChangeListener(this);
     }
 
     void paint(juce::Graphics &g) override { g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId)); }
@@ -50,7 +54,7 @@ class AudioTransportComponent : public juce::Component, public juce::Timer, publ
         stopButton.setBounds(buttonArea.removeFromLeft(100).reduced(margin));
 
         area.removeFromTop(margin);
-        positionSlider.setBounds(area.removeFromTop(buttonHeight).reduced(margin));
+        waveform.setBounds(area.reduced(margin, 0));
     }
 
     void loadButtonClicked() {
@@ -60,77 +64,52 @@ class AudioTransportComponent : public juce::Component, public juce::Timer, publ
         chooser->launchAsync(folderChooserFlags, [this](const juce::FileChooser &fc) {
             auto file = fc.getResult();
 
-            if (file != juce::File{}) {
-                auto *reader = formatManager.createReaderFor(file);
-
-                if (reader != nullptr) {
-                    auto newSource = std::make_unique<juce::AudioFormatReaderSource>(reader, true);
-                    transportSource.setSource(newSource.get(), 0, nullptr, reader->sampleRate);
-                    readerSource.reset(newSource.release());
-                }
-            }
+            if (file != juce::File{} && engine.loadFile(file))
+                waveform.setFile(file);
         });
     }
 
     void playButtonClicked() {
-        if (readerSource.get() == nullptr) {
+        if (!engine.hasFile()) {
             juce::NativeMessageBox::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon, "No File Loaded", "Please load an audio file first!");
             return;
         }
 
-        if (transportSource.isPlaying()) {
-            transportSource.stop();
+        if (engine.isPlaying()) {
+            engine.stop();
         } else {
-            transportSource.start();
+            engine.start();
         }
 
         updatePlayButtonText();
     }
 
     void stopButtonClicked() {
-        transportSource.stop();
-        transportSource.setPosition(0.0);
+        engine.stop();
+        engine.setPosition(0.0);
         updatePlayButtonText();
     }
 
-    void prepareToPlay(int samplesPerBlockExpected, double sampleRate) { transportSource.prepareToPlay(samplesPerBlockExpected, sampleRate); }
-
-    void getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill) {
-        if (readerSource.get() == nullptr) {
-            bufferToFill.clearActiveBufferRegion();
-            return;
-        }
-
-        transportSource.getNextAudioBlock(bufferToFill);
-    }
-
-    void releaseResources() { transportSource.releaseResources(); }
-
     void changeListenerCallback(juce::ChangeBroadcaster *) override { updatePlayButtonText(); }
 
     void timerCallback() override {
-        if (transportSource.isPlaying()) {
-            const double position = transportSource.getCurrentPosition();
-            const double length = transportSource.getLengthInSeconds();
+        const double length = engine.getLengthInSeconds();
 
-            if (length > 0.0)
-                positionSlider.setValue(position / length, juce::dontSendNotification);
-        }
+        if (engine.hasFile() && length > 0.0)
+            waveform.setPlayhead(engine.getCurrentPosition() / length);
     }
 
   private:
-    void updatePlayButtonText() { playButton.setButtonText(transportSource.isPlaying() ? "Pause" : "Play"); }
+    void updatePlayButtonText() { playButton.setButtonText(engine.isPlaying() ? "Pause" : "Play"); }
+
+    TransportEngine &engine;
 
     juce::TextButton loadButton;
     juce::TextButton playButton;
     juce::TextButton stopButton;
-    juce::Slider positionSlider;
+    WaveformView waveform{juce::Colours::lightblue};
 
     std::unique_ptr<juce::FileChooser> chooser;
 
-    juce::AudioFormatManager formatManager;
-    std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
-    juce::AudioTransportSource transportSource;
-
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AudioTransportComponent)
-};
\ No newline at end of file
+};
@@ -1,5 +1,8 @@
 #pragma once
+#include "IRLibrary.h"
+#include "LevelMeter.h"
 #include "PluginProcessor.h"
+#include "WaveformView.h"
 #include <JuceHeader.h>
 
 class BandControls : public juce::Component
@@ -11,22 +14,47 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
     void loadIRButtonClicked();
+    void browseIRButtonClicked();
 
 private:
     juce::Label nameLabel{"", "Band"};
     juce::TextButton irLoadButton{"Load IR"};
+    juce::TextButton irBrowseButton{"Browse"};
+    WaveformView irWaveform{juce::Colours::orange};
     juce::Slider mixSlider;
     juce::Label mixLabel;
     juce::Slider volumeSlider;
     juce::Label volumeLabel;
     juce::Slider crossoverSlider;
     juce::Label crossoverLabel;
+    juce::ComboBox modeBox;
+    juce::Label modeLabel;
+    juce::ComboBox engineBox;
+    juce::Label engineLabel;
+    juce::TextButton fitButton{"Fit to IR"};
+    juce::Slider decaySlider;
+    juce::Label decayLabel;
+    juce::Slider sizeSlider;
+    juce::Label sizeLabel;
+    juce::Slider densitySlider;
+    juce::Label densityLabel;
+    juce::Slider dampingSlider;
+    juce::Label dampingLabel;
     juce::TextButton soloButton{"S"};
     juce::TextButton muteButton{"M"};
+    LevelMeter levelMeter;
 
     std::unique_ptr<juce::FileChooser> fileChooser;
+
+    // Keeps the library scanning while the editor is open, not only while a browser is shown
+    juce::SharedResourcePointer<IRLibrary> irLibrary;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> crossoverAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> volumeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> modeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> engineAttachment;
+    std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>> fdnAttachments;
+
+    void updateEngineControls();
 
     juce::String name;
     size_t bandIdx;
@@ -0,0 +1,79 @@
+#pragma once
+#include <JuceHeader.h>
+
+// CpuGovernor.h
+// Measures how much of each block's deadline processBlock uses and steps quality down through
+// the tiers under sustained pressure, and back up one tier at a time once there is headroom
+// again. Tiers are cumulative, each one keeps the reductions of the tiers before it. Changes are
+// queued lock-free for the message thread, which writes them to the log and keeps a short
+// history for the editor.
+class CpuGovernor : public juce::ChangeBroadcaster, private juce::Timer {
+  public:
+    enum class Tier { Full, ShortTails, MonoLowBand, ReducedAnalyzer, AnalyzerPaused };
+    static constexpr int numTiers = 5;
+
+    enum class Reason { Pressure, Headroom, Disabled };
+
+    struct Event {
+        Tier from = Tier::Full;
+        Tier to = Tier::Full;
+        Reason reason = Reason::Pressure;
+        float load = 0.0f; // Smoothed share of the deadline used when the change was made
+        juce::uint32 timeMs = 0;
+    };
+
+    CpuGovernor();
+    ~CpuGovernor() override;
+
+    // prepare from prepareToPlay, the rest on the audio thread. Disabling returns straight to
+    // full quality.
+    void prepare(double newSampleRate);
+    void setEnabled(bool shouldBeEnabled);
+    void endBlock(juce::int64 elapsedTicks, int numSamples);
+
+    // Any thread
+    Tier getTier() const { return tier.load(std::memory_order_relaxed); }
+    float getLoad() const { return load.load(std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Message thread, oldest first
+    const std::deque<Event> &getHistory() const { return history; }
+
+    static const char *getTierName(Tier t);
+    static juce::String describe(const Event &event);
+
+  private:
+    void timerCallback() override;
+    void changeTier(Tier newTier, Reason reason);
+
+    // Step down when the smoothed load stays above stepDownLoad for stepDownSeconds, up when it
+    // stays below stepUpLoad for stepUpSeconds. No step follows another within holdSeconds so
+    // each transition can finish and the load settle first.
+    static constexpr float stepDownLoad = 0.75f;
+    static constexpr float stepUpLoad = 0.45f;
+    static constexpr double stepDownSeconds = 0.25;
+    static constexpr double stepUpSeconds = 3.0;
+    static constexpr double holdSeconds = 1.0;
+    static constexpr double loadSmoothingSeconds = 0.1;
+    static constexpr size_t maxHistory = 32;
+
+    double sampleRate = 44100.0;
+    double ticksPerSecond = 1.0;
+
+    // Audio thread
+    float smoothedLoad = 0.0f;
+    double secondsAbove = 0.0;
+    double secondsBelow = 0.0;
+    double secondsSinceChange = 0.0;
+
+    std::atomic<Tier> tier{Tier::Full};
+    std::atomic<float> load{0.0f};
+    std::atomic<bool> enabled{false};
+
+    juce::AbstractFifo eventFifo{64};
+    std::array<Event, 64> events;
+
+    std::deque<Event> history;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CpuGovernor)
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Crossover.h
+// Linkwitz-Riley band split of order 2, 4 or 8 whose cutoff can be moved from the audio thread.
+// The cutoff glides to its target in the log domain, with coefficients refreshed every few
+// samples from a tan table so continuous sweeps stay cheap and free of zipper noise. The filter
+// cascade for each order is unrolled at compile time, the three orders are instantiated in
+// Crossover.cpp.
+template <int Order> class LinkwitzRileyCrossover {
+    static_assert(Order == 2 || Order == 4 || Order == 8, "Linkwitz-Riley crossovers are available in orders 2, 4 and 8");
+
+  public:
+    void prepare(const juce::dsp::ProcessSpec &spec);
+
+    // Clears the filter state, the next target frequency is jumped to rather than glided to
+    void reset();
+
+    // Audio thread only. The first call after prepare or reset jumps straight to the frequency.
+    void setTargetFrequency(float frequency);
+
+    // Splits input into low and high, which sum to an allpass of the input. Input may alias low.
+    // A band that skips this split can be passed as compensate, it is run in place through the
+    // same allpass so it stays in phase with low + high.
+    void process(const juce::dsp::AudioBlock<float> &input, juce::dsp::AudioBlock<float> &low, juce::dsp::AudioBlock<float> &high, juce::dsp::AudioBlock<float> *compensate = nullptr);
+
+  private:
+    // The Butterworth filter of half the order run twice. Order 2 uses one critically damped
+    // section, higher orders one section per Butterworth pole pair.
+    static constexpr size_t numDampings = Order == 8 ? 2 : 1;
+    static constexpr size_t numLowpassSections = Order / 2;
+
+    // Integrator states of one state variable section
+    struct Section {
+        float z1 = 0.0f;
+        float z2 = 0.0f;
+    };
+
+    // The lowpass cascade, the extra allpass sections needed to derive the highpass, and the
+    // allpass applied to a compensated band
+    struct ChannelState {
+        std::array<Section, numLowpassSections> lowpass;
+        std::array<Section, numDampings - 1> allpass;
+        std::array<Section, numDampings> compensation;
+    };
+
+    void updateCoefficients(float frequency);
+
+    static constexpr int coefficientInterval = 16; // Samples between coefficient updates
+    static constexpr double glideSeconds = 0.02;
+
+    double sampleRate = 44100.0;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> cutoff{1000.0f};
+    bool hasTarget = false;
+
+    float g = 0.0f; // tan(pi * fc / fs)
+    std::array<float, numDampings> h{}; // 1 / (1 + k * g + g * g) for each damping k
+    std::array<float, numDampings> kg{}; // k + g for each damping k
+
+    std::vector<ChannelState> states;
+};
+
+extern template class LinkwitzRileyCrossover<2>;
+extern template class LinkwitzRileyCrossover<4>;
+extern template class LinkwitzRileyCrossover<8>;
+
+// Low, mid and high from two crossovers of one slope. The low band runs through the upper
+// crossover's allpass so the three bands sum flat at every slope. Each slope is its own
+// specialisation, chosen once per block. A slope change runs the old and new slope side by side
+// for a few milliseconds and crossfades their bands, so it doesn't click.
+class ThreeBandCrossover {
+  public:
+    enum class Slope { LR2, LR4, LR8 };
+
+    void prepare(const juce::dsp::ProcessSpec &spec);
+    void reset();
+
+    // Audio thread only. A new slope starts from a cleared state at the current frequencies and
+    // fades in over the old one. A change during a fade drops the slope that was fading out.
+    void setSlope(Slope newSlope);
+    void setTargetFrequencies(float lowMid, float midHigh);
+
+    // Input may alias low
+    void process(const juce::dsp::AudioBlock<float> &input, juce::dsp::AudioBlock<float> &low, juce::dsp::AudioBlock<float> &mid, juce::dsp::AudioBlock<float> &high);
+
+  private:
+    template <int Order> struct Split {
+        LinkwitzRileyCrossover<Order> lowMid;
+        LinkwitzRileyCrossover<Order> midHigh;
+    };
+
+    // Calls fn with the split for a slope
+    template <typename Fn> void visitSplit(Slope which, Fn &&fn);
+
+    std::tuple<Split<2>, Split<4>, Split<8>> splits;
+    Slope slope = Slope::LR4;
+
+    // The slope faded out after a change, with its bands in fadeBuffer, numChannels per band
+    Slope fadingSlope = Slope::LR4;
+    int fadeLength = 0;
+    int fadePosition = 0;
+    bool isFading = false;
+    size_t numChannels = 0;
+    juce::AudioBuffer<float> fadeBuffer;
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <JuceHeader.h>
+
+#ifndef MBR_ENABLE_PROFILER
+#define MBR_ENABLE_PROFILER 0
+#endif
+
+// DspProfiler.h
+// Per-stage timings of processBlock. The audio thread accumulates high resolution ticks for each
+// stage into the current frame and pushes one frame per block into a lock-free FIFO that the
+// editor drains. Use the MBR_PROFILE_* macros so the timers disappear when the profiler is compiled out.
+class DspProfiler {
+  public:
+    enum Stage { Transport, Crossover, LowBand, MidBand, HighBand, Mix, Analyzer, Total, NumStages };
+
+    struct Frame {
+        std::array<juce::int64, NumStages> ticks{};
+        int numSamples = 0;
+        double sampleRate = 0.0;
+    };
+
+    // Stats for one stage over the frames handed to computeStats, in microseconds
+    struct StageStats {
+        double minMicros = 0.0;
+        double avgMicros = 0.0;
+        double p99Micros = 0.0;
+        double maxMicros = 0.0;
+        double avgDeadlinePercent = 0.0;
+        double maxDeadlinePercent = 0.0;
+    };
+
+    DspProfiler();
+
+    void prepare(double newSampleRate) { sampleRate = newSampleRate; }
+
+    // Audio thread
+    void beginBlock(int numSamples);
+    void addTicks(Stage stage, juce::int64 ticks) { current.ticks[static_cast<size_t>(stage)] += ticks; }
+    void endBlock();
+
+    // Reader thread, returns the number of frames appended
+    int readFrames(std::vector<Frame> &destination);
+    int getNumDroppedFrames() const { return droppedFrames.load(std::memory_order_relaxed); }
+
+    static std::array<StageStats, NumStages> computeStats(const std::vector<Frame> &frames);
+    static double ticksToMicros(juce::int64 ticks);
+    static const char *getStageName(Stage stage);
+    static bool writeCsv(const std::vector<Frame> &frames, juce::OutputStream &out);
+
+    // Adds the lifetime of the scope to a stage
+    class StageScope {
+      public:
+        StageScope(DspProfiler &p, Stage s) : profiler(p), stage(s), start(juce::Time::getHighResolutionTicks()) {}
+        ~StageScope() { profiler.addTicks(stage, juce::Time::getHighResolutionTicks() - start); }
+
+      private:
+        DspProfiler &profiler;
+        Stage stage;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(StageScope)
+    };
+
+    // Opens a frame and records the whole block as the Total stage
+    class BlockScope {
+      public:
+        BlockScope(DspProfiler &p, int numSamples) : profiler(p) {
+            profiler.beginBlock(numSamples);
+            start = juce::Time::getHighResolutionTicks();
+        }
+
+        ~BlockScope() {
+            profiler.addTicks(Total, juce::Time::getHighResolutionTicks() - start);
+            profiler.endBlock();
+        }
+
+      private:
+        DspProfiler &profiler;
+        juce::int64 start = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(BlockScope)
+    };
+
+  private:
+    static constexpr int fifoSize = 1024;
+
+    juce::AbstractFifo fifo{fifoSize};
+    std::vector<Frame> frames;
+    Frame current;
+    double sampleRate = 44100.0;
+    std::atomic<int> droppedFrames{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DspProfiler)
+};
+
+#if MBR_ENABLE_PROFILER
+#define MBR_PROFILE_BLOCK(profiler, numSamples) DspProfiler::BlockScope mbrProfileBlock(profiler, numSamples)
+#define MBR_PROFILE_STAGE(profiler, stage) DspProfiler::StageScope JUCE_JOIN_MACRO(mbrProfileStage, __LINE__)(profiler, stage)
+#else
+#define MBR_PROFILE_BLOCK(profiler, numSamples)
+#define MBR_PROFILE_STAGE(profiler, stage)
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+#include <JuceHeader.h>
+
+// FdnReverb.h
+// Feedback delay network reverb with a fixed cost per sample regardless of decay time. Eight
+// delay lines are processed as one 8-wide vector per sample: fractional reads, one-pole damping
+// and decay gains, then a fast Walsh-Hadamard mix written back into the lines.
+class FdnReverb {
+  public:
+    static constexpr size_t numLines = 8;
+
+    struct Parameters {
+        float decaySeconds = 2.0f; // RT60 of the tail
+        float size = 0.5f;         // 0..1, scales the delay line lengths
+        float density = 0.7f;      // 0..1, input diffusion
+        float damping = 0.3f;      // 0..1, high frequency loss per pass
+
+        bool operator==(const Parameters &) const = default;
+    };
+
+    void prepare(const juce::dsp::ProcessSpec &spec);
+    void reset();
+
+    // Cheap when nothing changed, safe to call every block from the audio thread
+    void setParameters(const Parameters &newParameters);
+
+    // Sums the input channels, writes decorrelated wet signals to every channel
+    void process(const juce::dsp::ProcessContextReplacing<float> &context);
+
+    // Estimates decay and damping from the part of an IR between two frequencies, so a band can
+    // move from convolution to the FDN without a large change in character
+    static Parameters fitToImpulseResponse(const juce::AudioBuffer<float> &ir, double irSampleRate, float lowFrequency, float highFrequency, Parameters current);
+
+    // RT60 of the first channel between two frequencies, zero when it can't be estimated
+    static float estimateBandDecayTime(const juce::AudioBuffer<float> &ir, double irSampleRate, float lowFrequency, float highFrequency);
+
+  private:
+    using Frame = std::array<float, numLines>;
+
+    static constexpr size_t numDiffusers = 4;
+
+    void updateCoefficients();
+    float diffuse(float input);
+    static void hadamard(Frame &frame);
+
+    double sampleRate = 44100.0;
+    Parameters parameters;
+
+    // Frame-interleaved, sample n of line i is at n * numLines + i
+    std::vector<float> delayMemory;
+    size_t lineLength = 0; // Frames
+    size_t lineMask = 0;
+    size_t writeIndex = 0;
+
+    alignas(32) Frame targetDelays{};
+    alignas(32) Frame currentDelays{};
+    alignas(32) Frame decayGains{};
+    alignas(32) Frame dampingStates{};
+    float dampingCoefficient = 0.0f;
+
+    std::array<std::vector<float>, numDiffusers> diffuserMemory;
+    std::array<size_t, numDiffusers> diffuserIndices{};
+    float diffusion = 0.5f;
+};
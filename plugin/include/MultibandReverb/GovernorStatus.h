@@ -0,0 +1,30 @@
+#pragma once
+#include "PluginProcessor.h"
+#include <JuceHeader.h>
+
+// GovernorStatus.h
+// CPU governor switch with the current load and tier, and the most recent tier change below.
+// The full history is in the tooltip.
+class GovernorStatus : public juce::Component, public juce::SettableTooltipClient, public juce::Timer, private juce::ChangeListener {
+  public:
+    explicit GovernorStatus(MultibandReverbAudioProcessor &processor);
+    ~GovernorStatus() override;
+
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+    void timerCallback() override;
+
+  private:
+    void changeListenerCallback(juce::ChangeBroadcaster *) override;
+
+    MultibandReverbAudioProcessor &processorRef;
+
+    juce::ToggleButton enableButton{"CPU Governor"};
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> enableAttachment;
+
+    float load = 0.0f;
+    CpuGovernor::Tier tier = CpuGovernor::Tier::Full;
+    juce::String lastChange;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GovernorStatus)
+};
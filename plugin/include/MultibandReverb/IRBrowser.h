@@ -0,0 +1,59 @@
+#pragma once
+#include "IRLibrary.h"
+#include "WaveformView.h"
+#include <JuceHeader.h>
+
+// IRBrowser.h
+// Searchable, sortable table of the IR library with a preview of the selected file. Filtering and
+// sorting work on an in-memory copy of the index, previews come from the waveform cache the
+// scan filled. Shown in a CallOutBox, which is dismissed once an IR is picked.
+class IRBrowser : public juce::Component, private juce::TableListBoxModel, private juce::ChangeListener {
+  public:
+    // The hash of the band's current IR, its row is highlighted
+    explicit IRBrowser(juce::uint64 currentHash);
+    ~IRBrowser() override;
+
+    std::function<void(const juce::File &)> onLoad;
+
+    void resized() override;
+
+  private:
+    enum Column { nameColumn = 1, lengthColumn, rateColumn, channelsColumn, lowDecayColumn, midDecayColumn, highDecayColumn };
+
+    int getNumRows() override;
+    void paintRowBackground(juce::Graphics &g, int row, int width, int height, bool isSelected) override;
+    void paintCell(juce::Graphics &g, int row, int columnId, int width, int height, bool isSelected) override;
+    void sortOrderChanged(int newSortColumnId, bool isForwards) override;
+    void selectedRowsChanged(int lastRowSelected) override;
+    void cellDoubleClicked(int row, int columnId, const juce::MouseEvent &) override;
+    void returnKeyPressed(int lastRowSelected) override;
+
+    void changeListenerCallback(juce::ChangeBroadcaster *) override;
+    void chooseFolder();
+    void updateStatus();
+    void updateRows();
+    void loadRow(int row);
+
+    static juce::String getCellText(const IRLibrary::Entry &entry, int columnId);
+
+    juce::SharedResourcePointer<IRLibrary> library;
+    juce::uint64 highlightHash;
+
+    juce::TextButton folderButton{"Folder..."};
+    juce::TextButton rescanButton{"Rescan"};
+    juce::Label statusLabel;
+    juce::TextEditor searchBox;
+    juce::TableListBox table{"IR Library", this};
+    WaveformView preview{juce::Colours::orange};
+    juce::TextButton loadButton{"Load"};
+
+    std::unique_ptr<juce::FileChooser> folderChooser;
+
+    std::vector<IRLibrary::Entry> entries; // Snapshot of the library
+    std::vector<size_t> rows;              // Entries matching the search, in table order
+    int sortColumn = nameColumn;
+    bool isSortedForwards = true;
+    juce::File previewFile;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IRBrowser)
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include "WaveformCache.h"
+#include <JuceHeader.h>
+
+// IRLibrary.h
+// Index of every audio file under the IR folder, shared through juce::SharedResourcePointer.
+// A low priority thread decodes files that are new or changed since the last scan (by
+// modification time and size) for their format, per band RT60 and ImpulseResponseLoader content
+// hash, and stores each file's waveform overview in the WaveformCache on the way so previews
+// never read the file again. The index is kept on disk and reloaded by the thread when it starts,
+// so only files added or edited since then are decoded.
+class IRLibrary : public juce::ChangeBroadcaster, private juce::Thread {
+  public:
+    struct Entry {
+        juce::File file;
+        juce::int64 modificationTime = 0; // Milliseconds since the epoch
+        juce::int64 fileSize = 0;
+        double sampleRate = 0.0;
+        int numChannels = 0;
+        juce::int64 length = 0;
+        std::array<float, 3> rt60{}; // Low, mid and high band, zero where it couldn't be estimated
+        juce::uint64 hash = 0;
+
+        double getLengthSeconds() const { return sampleRate > 0.0 ? static_cast<double>(length) / sampleRate : 0.0; }
+    };
+
+    IRLibrary();
+    ~IRLibrary() override;
+
+    // Message thread. Changing the folder drops the old index and scans the new one.
+    void setFolder(const juce::File &newFolder);
+    juce::File getFolder() const;
+    void rescan();
+
+    // Any thread. A copy, so it can be filtered and sorted without holding up the scan.
+    std::vector<Entry> getEntries() const;
+    bool isScanning() const { return scanning.load(std::memory_order_relaxed); }
+    float getProgress() const { return progress.load(std::memory_order_relaxed); }
+
+    // Bands the RT60 is measured in, the default crossover frequencies
+    static constexpr float lowMidFrequency = 250.0f;
+    static constexpr float midHighFrequency = 2500.0f;
+
+  private:
+    void run() override;
+    void scan(const juce::File &folderToScan);
+    bool readEntry(Entry &entry);
+
+    void loadIndex();
+    void saveIndex() const;
+
+    static constexpr int indexVersion = 1;
+    static constexpr int chunkSize = 65536;
+    static constexpr int maxDecaySamples = 1 << 22; // The RT60 only looks at the head of very long files
+    static constexpr double notifyIntervalMs = 250.0;
+    static constexpr int saveInterval = 64; // Files decoded between index saves during a scan
+
+    juce::File indexFile;
+    juce::AudioFormatManager formatManager;
+    juce::SharedResourcePointer<WaveformCache> waveformCache;
+
+    mutable juce::CriticalSection lock;
+    juce::File folder;
+    std::map<juce::String, Entry> entries; // By full path
+
+    std::atomic<bool> scanRequested{false};
+    std::atomic<bool> scanning{false};
+    std::atomic<float> progress{0.0f};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(IRLibrary)
+};
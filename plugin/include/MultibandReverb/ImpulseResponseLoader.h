@@ -0,0 +1,73 @@
+#pragma once
+#include <JuceHeader.h>
+
+// ImpulseResponseLoader.h
+// One background thread per process that decodes IR files for every band of every instance.
+// Share it through juce::SharedResourcePointer. Jobs are taken highest priority first, so an IR
+// picked by the user jumps ahead of IRs queued while a session is restored. Files are streamed
+// one StreamingConvolution slot at a time so the head of a long IR is delivered first, and a
+// stream steps aside between slots for a job of higher priority and resumes after it.
+class ImpulseResponseLoader : private juce::Thread {
+  public:
+    enum class Priority { SessionRestore, Interactive };
+
+    // Receives decoded IRs on the loader thread: a start, the mono segment for each slot in
+    // order, then a finish unless the job was superseded or cancelled part way through
+    class Client {
+      public:
+        virtual ~Client() = default;
+        virtual void impulseResponseStarted(size_t bandIndex, const juce::File &file, juce::int64 length, double sampleRate) = 0;
+        virtual void impulseResponseSegmentLoaded(size_t bandIndex, size_t slot, juce::AudioBuffer<float> &&segment) = 0;
+        virtual void impulseResponseFinished(size_t bandIndex) = 0;
+    };
+
+    ImpulseResponseLoader();
+    ~ImpulseResponseLoader() override;
+
+    // Queues a file for a band, replacing any pending job for the same band. Returns false if the
+    // queue is full of jobs with at least this priority.
+    bool load(Client &client, size_t bandIndex, const juce::File &file, Priority priority);
+
+    // Drops pending jobs for a client and waits for a delivery in progress, call before destroying it
+    void cancelJobsFor(Client &client);
+
+    // Content hash of an IR: FNV-1a from hashSeed over the sample rate, then the first channel's
+    // samples in order. Clients build it from the segments they are sent, the IR library from
+    // the files it scans, so both agree on which IRs are identical.
+    static constexpr juce::uint64 hashSeed = 14695981039346656037ull;
+    static juce::uint64 hashBytes(juce::uint64 hash, const void *data, size_t numBytes);
+
+  private:
+    struct Job {
+        Client *client = nullptr;
+        size_t bandIndex = 0;
+        juce::File file;
+        Priority priority = Priority::Interactive;
+        juce::uint64 sequence = 0;
+
+        // Set when a stream stepped aside: the slot to resume from and the length it started with
+        size_t firstSlot = 0;
+        juce::int64 length = 0;
+    };
+
+    void run() override;
+    bool popNextJob(Job &job);
+    bool isSuperseded(const Job &job);
+    bool yieldToHigherPriority(const Job &job, size_t nextSlot, juce::int64 length);
+
+    // Calls back into the job's client unless it was cancelled, returns false if it was
+    template <typename Callback>
+    bool deliver(const Job &job, Callback &&callback);
+
+    static constexpr size_t maxPendingJobs = 256;
+
+    juce::CriticalSection queueLock;
+    juce::CriticalSection deliveryLock;
+    std::vector<Job> pendingJobs;
+    Client *runningClient = nullptr;
+    juce::uint64 nextSequence = 0;
+
+    juce::AudioFormatManager formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ImpulseResponseLoader)
+};
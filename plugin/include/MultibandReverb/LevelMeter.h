@@ -0,0 +1,28 @@
+#pragma once
+#include "PluginProcessor.h"
+#include <JuceHeader.h>
+
+// LevelMeter.h
+// Input and reverb level bars for one band, polled from the processor.
+class LevelMeter : public juce::Component, public juce::Timer {
+  public:
+    LevelMeter(MultibandReverbAudioProcessor &processor, size_t bandIndex);
+    ~LevelMeter() override;
+
+    void paint(juce::Graphics &g) override;
+    void timerCallback() override;
+
+  private:
+    void drawBar(juce::Graphics &g, juce::Rectangle<float> area, MultibandReverbAudioProcessor::LevelReading level, const juce::String &label) const;
+
+    static constexpr float minDb = -60.0f;
+    static constexpr float maxDb = 6.0f;
+
+    MultibandReverbAudioProcessor &processorRef;
+    size_t bandIdx;
+
+    MultibandReverbAudioProcessor::LevelReading inputLevel;
+    MultibandReverbAudioProcessor::LevelReading reverbLevel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeter)
+};
@@ -2,8 +2,11 @@
 #pragma once
 
 #include "PluginProcessor.h"
+#include "AudioTransport.h"
 #include "SpectrumAnalyzer.h"
 #include "BandControls.h"
+#include "GovernorStatus.h"
+#include "ProfilerOverlay.h"
 
 class MultibandReverbAudioProcessorEditor : public juce::AudioProcessorEditor {
     public:
@@ -14,16 +17,36 @@ class MultibandReverbAudioProcessorEditor : public juce::AudioProcessorEditor {
       void resized() override;
 
     private:
+#if MBR_STARTUP_TIMING
+      // First member, so construction is timed from before the child components are built
+      const juce::int64 openedTicks = juce::Time::getHighResolutionTicks();
+      bool hasPainted = false;
+
+      void paintOverChildren(juce::Graphics &) override;
+#endif
+
       MultibandReverbAudioProcessor &processorRef;
       SpectrumAnalyzer analyzer;
+      juce::TextButton spectrogramButton{"Spectrogram"};
+      AudioTransportComponent transportView{processorRef.transport};
+      GovernorStatus governorStatus{processorRef};
+      juce::TooltipWindow tooltipWindow{this};
 
       BandControls lowBand{"Low", 0, processorRef};
       BandControls midBand{"Mid", 1, processorRef};
       BandControls highBand{"High", 2, processorRef};
       juce::Slider lowCrossoverSlider;
       juce::Slider midCrossoverSlider;
+      juce::ComboBox slopeBox;
+      juce::Label slopeLabel;
 
       std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>> sliderAttachments;
+      std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> slopeAttachment;
+
+#if MBR_ENABLE_PROFILER
+      juce::TextButton profilerButton{"Profiler"};
+      ProfilerOverlay profilerOverlay{processorRef.profiler};
+#endif
 
       void attachSliders();
 
@@ -1,19 +1,38 @@
 #pragma once
 
-#include "AudioTransport.h"
+#include "CpuGovernor.h"
+#include "Crossover.h"
+#include "DspProfiler.h"
+#include "FdnReverb.h"
+#include "ImpulseResponseLoader.h"
+#include "RealtimeSafety.h"
 #include "SpectrumAnalyzer.h"
+#include "StartupTiming.h"
+#include "StreamingConvolution.h"
+#include "TransportEngine.h"
+#include "WorkerPool.h"
 #include <JuceHeader.h>
 
+#ifndef MBR_INTERNAL_BLOCK_SIZE
+#define MBR_INTERNAL_BLOCK_SIZE 256
+#endif
+
 class SpectrumAnalyzer;
 
-class MultibandReverbAudioProcessor : public juce::AudioProcessor, public juce::AudioProcessorValueTreeState::Listener {
+class MultibandReverbAudioProcessor : public juce::AudioProcessor, private ImpulseResponseLoader::Client {
   public:
+#if MBR_STARTUP_TIMING
+    // First member, so construction is timed from before the parameters are built
+    StartupTiming startupTiming;
+#endif
+
     MultibandReverbAudioProcessor();
     ~MultibandReverbAudioProcessor() override;
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
     void processBlock(juce::AudioBuffer<float> &, juce::MidiBuffer &) override;
+    bool isBusesLayoutSupported(const BusesLayout &layouts) const override;
     SpectrumAnalyzer *analyzer = nullptr;
 
     juce::AudioProcessorEditor *createEditor() override;
@@ -33,27 +52,83 @@ class MultibandReverbAudioProcessor : public juce::AudioProcessor, public juce::
     void getStateInformation(juce::MemoryBlock &destData) override;
     void setStateInformation(const void *data, int sizeInBytes) override;
 
-    void parameterChanged(const juce::String &parameterID, float newValue) override;
-
     juce::AudioProcessorValueTreeState parameters;
-    AudioTransportComponent transportComponent;
+    TransportEngine transport;
 
-    void updateCrossoverFrequencies();
+    // Host blocks are split into sub-blocks of at most this many samples. Tune it against the
+    // cache size of the target machine, changes apply on the next prepareToPlay.
+    static constexpr int defaultInternalBlockSize = MBR_INTERNAL_BLOCK_SIZE;
+    static constexpr int minInternalBlockSize = 16;
+    static constexpr int maxInternalBlockSize = 8192;
+    int getInternalBlockSize() const;
+    void setInternalBlockSize(int newSize);
+
+    // How each band feeds its reverb. Mono Sum and Mid Only run a single convolution channel and
+    // spread it back, Mid Only passes the side signal through dry.
+    enum class ReverbMode { Stereo, MonoSum, MidOnly };
+
+    // Which engine produces a band's reverb. The FDN has a fixed cost independent of tail length.
+    enum class ReverbEngine { Convolution, Fdn };
+
+    // Matching input and output layouts up to this many channels are accepted, e.g. 7.1.4 or
+    // third order ambisonics
+    static constexpr int maxChannels = 16;
+
+    // Which channels feed the reverbs, the rest only carry the dry bands. All skips LFE channels,
+    // Front Only falls back to the first pair when the layout has no front channels.
+    enum class ReverbSends { All, FrontOnly, FirstPair };
+
+    // Per-band parameter IDs are the band prefix ("low", "mid", "high") followed by the suffix
+    static juce::String getBandParameterID(size_t bandIndex, const juce::String &suffix);
+
+    // Queues the file on the shared loader and stores its path with the session. The IR is
+    // swapped in on the loader thread once decoded.
     void loadImpulseResponse(size_t bandIndex, const juce::File &irFile);
+    juce::File getImpulseResponseFile(size_t bandIndex) const;
 
-    struct CrossoverFilter {
-        juce::dsp::LinkwitzRileyFilter<float> lowpass;
-        juce::dsp::LinkwitzRileyFilter<float> highpass;
+    // ImpulseResponseLoader content hash of the band's IR once fully loaded, zero otherwise
+    juce::uint64 getImpulseResponseHash(size_t bandIndex) const { return irHashes[bandIndex].load(std::memory_order_relaxed); }
+
+    // Sets the band's FDN decay and damping from its loaded IR, returns false without an IR
+    bool fitFdnToImpulseResponse(size_t bandIndex);
+
+    // Level metering, readable from any thread. Each band is metered after the crossover and at
+    // its reverb output, bands sharing a convolution all report the shared wet signal. Readings
+    // are linear gain: peak falls back at 20 dB/s, RMS is averaged over about 300 ms. Metering
+    // only runs while at least one client is registered, editors and headless tools alike.
+    struct LevelReading {
+        float peak = 0.0f;
+        float rms = 0.0f;
     };
 
+    LevelReading getBandInputLevel(size_t bandIndex) const;
+    LevelReading getBandReverbLevel(size_t bandIndex) const;
+    LevelReading getOutputLevel() const;
+    void addMeteringClient();
+    void removeMeteringClient();
+
+    // Reverb engines for one group of up to two send channels, JUCE's convolution is stereo at most
+    struct ReverbEngines {
+        std::unique_ptr<StreamingConvolution> convolution;
+        FdnReverb fdn;
+
+        explicit ReverbEngines(StreamingConvolution::MessageQueue &queue) : convolution(std::make_unique<StreamingConvolution>(queue)) {}
+    };
+
+    // At most this much of each IR is kept in irBuffer for fitting the FDN
+    static constexpr juce::int64 maxAnalysisSamples = juce::int64{1} << 22;
+
     struct BandReverb {
-        std::unique_ptr<juce::dsp::Convolution> convolution;
+        std::vector<ReverbEngines> groups; // One per channel group, sized in prepareToPlay
         juce::AudioBuffer<float> irBuffer;
+        double irSampleRate = 0.0;
+        float irGain = 1.0f;                 // Normalisation taken from the IR's head
+        juce::uint64 pendingIrHash = 0;      // Hash of the segments streamed so far
         float mix = 0.5f;
         bool isSoloed = false;
         bool isMuted = false;
 
-        BandReverb() : convolution(std::make_unique<juce::dsp::Convolution>()) {}
+        BandReverb() = default;
 
         // Explicitly delete copy operations
         BandReverb(const BandReverb &) = delete;
@@ -66,14 +141,138 @@ class MultibandReverbAudioProcessor : public juce::AudioProcessor, public juce::
 
     void updateSoloMuteStates();
 
-    std::vector<CrossoverFilter> crossovers;
+    // Every engine in the process builds its IR swaps on one background thread, only the loader
+    // thread posts to it. Declared before bandReverbs so it outlives them.
+    juce::SharedResourcePointer<StreamingConvolution::MessageQueue> convolutionQueue;
+
+    ThreeBandCrossover crossover;
     std::vector<BandReverb> bandReverbs;
 
+#if MBR_ENABLE_PROFILER
+    DspProfiler profiler;
+#endif
+
+    // Scales quality down under CPU pressure while the cpuGovernor parameter is on
+    CpuGovernor governor;
+
   private:
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+    void processSubBlock(juce::AudioBuffer<float> &buffer, int startSample, int numSamples);
+    void updateCrossoverFrequencies();
+    bool hasReverb(size_t bandIndex, ReverbEngine engine) const;
+    float getReverbLevel(size_t leader, ReverbEngine engine) const;
+    size_t getConvolutionLeader(size_t bandIndex, const std::array<ReverbMode, 3> &modes, const std::array<ReverbEngine, 3> &engines) const;
+    void processBandReverb(ReverbEngines &reverb, const juce::dsp::AudioBlock<float> &bandBlock, juce::dsp::AudioBlock<float> &wetBlock, ReverbMode mode, ReverbEngine engine);
+    void runReverbGroups(size_t numGroups);
+    void processReverbGroup(size_t group);
+    void prepareReverbGroups(const juce::dsp::ProcessSpec &spec);
+    void accumulateLevel(size_t meterIndex, const juce::dsp::AudioBlock<float> &block);
+    void publishLevels(int numSamples);
+    LevelReading getLevel(size_t meterIndex) const;
+    void impulseResponseStarted(size_t bandIndex, const juce::File &file, juce::int64 length, double sampleRate) override;
+    void impulseResponseSegmentLoaded(size_t bandIndex, size_t slot, juce::AudioBuffer<float> &&segment) override;
+    void impulseResponseFinished(size_t bandIndex) override;
+    void restoreImpulseResponses();
+    void applyGovernorTier(CpuGovernor::Tier tier);
+    void setTailLimit(bool isShort);
+    void updateLowBandMono();
+
+    static inline const juce::Identifier internalBlockSizeID{"internalBlockSize"};
+    int preparedBlockSize = defaultInternalBlockSize;
+
+    juce::SharedResourcePointer<ImpulseResponseLoader> irLoader;
+
+    // Guards the IR fields of BandReverb and the size of groups, used by the loader thread
+    juce::CriticalSection irLock;
+
+    // One or two send channels convolved by one set of engines. Only a left channel and its right
+    // partner share a group, in that order, so Mid Only always sees a real stereo pair.
+    struct SendGroup {
+        size_t firstSend = 0; // Index into the send channel list, the group's channels follow on
+        size_t numChannels = 0;
+    };
+
+    // Send channels and their groups for each ReverbSends choice, built from the layout in
+    // prepareToPlay. The channel lists are ordered group by group.
+    std::array<std::vector<size_t>, 3> sendChannelSets;
+    std::array<std::vector<SendGroup>, 3> sendGroupSets;
+
+    // Channel groups are spread over the workers once a layout has at least this many
+    static constexpr size_t minParallelGroups = 3;
+    juce::SharedResourcePointer<WorkerPool> reverbWorkers;
+
+    // What processReverbGroup works on for the group leader being processed
+    struct ReverbGroupJob {
+        size_t leader = 0;
+        size_t length = 0;
+        const std::vector<size_t> *sendChannels = nullptr;
+        const std::vector<SendGroup> *sendGroups = nullptr;
+        std::array<const juce::dsp::AudioBlock<float> *, 3> bandBlocks{};
+        std::array<float, 3> memberGains{}; // Zero for bands outside the leader's group
+        ReverbMode mode = ReverbMode::Stereo;
+        ReverbEngine engine = ReverbEngine::Convolution;
+    };
+    ReverbGroupJob reverbJob;
 
     std::atomic<float> *lowCrossoverFreq = nullptr;
     std::atomic<float> *midCrossoverFreq = nullptr;
+    std::atomic<float> *crossoverSlope = nullptr;
+    std::atomic<float> *reverbSends = nullptr;
+    std::atomic<float> *governorEnabled = nullptr;
+    std::array<std::atomic<float> *, 3> bandVolumes{};
+    std::array<std::atomic<float> *, 3> bandModes{};
+    std::array<std::atomic<float> *, 3> bandEngines{};
+    std::array<std::atomic<float> *, 3> fdnDecays{};
+    std::array<std::atomic<float> *, 3> fdnSizes{};
+    std::array<std::atomic<float> *, 3> fdnDensities{};
+    std::array<std::atomic<float> *, 3> fdnDampings{};
+
+    // Meters 0-2 are the band inputs, 3-5 the band reverbs and 6 the output
+    static constexpr size_t numMeters = 7;
+    static constexpr size_t reverbMeterOffset = 3;
+    static constexpr size_t outputMeter = 6;
+
+    std::atomic<int> meteringClients{0};
+    bool isMeteringBlock = false;
+    std::array<float, numMeters> blockPeaks{};
+    std::array<float, numMeters> blockMeanSquares{};
+    std::array<float, numMeters> smoothedMeanSquares{};
+    std::array<std::atomic<float>, numMeters> meterPeaks{};
+    std::array<std::atomic<float>, numMeters> meterRms{};
+
+    // Governor tier in effect on the audio thread. Short tails keep this many streaming slots,
+    // about 2.4 s at 48 kHz.
+    static constexpr size_t shortTailSlots = 3;
+    CpuGovernor::Tier appliedTier = CpuGovernor::Tier::Full;
+
+    // The low band goes mono by ducking its wet signal, switching while silent and fading back in.
+    // It shares its convolution with other bands only while stereo at full level.
+    bool isLowBandMono = false;
+    bool isLowBandShareable = true;
+    juce::SmoothedValue<float> lowBandWetGain{1.0f};
+
+    // Convolution group leader, engine and input mode of each band in the last sub-block, the
+    // run mode being the one its engines were actually fed with
+    std::array<size_t, 3> previousLeaders{0, 1, 2};
+    std::array<ReverbEngine, 3> previousEngines{};
+    std::array<ReverbMode, 3> previousModes{};
+    std::array<ReverbMode, 3> previousRunModes{};
+
+    // Samples left for a band that joined another band's convolution to ring out on its own
+    // engines, and the mode they ran in
+    std::array<juce::int64, 3> drainSamples{};
+    std::array<ReverbMode, 3> drainModes{};
+
+    // Content hash of each band's IR, zero while no IR is loaded
+    std::array<std::atomic<juce::uint64>, 3> irHashes{};
+
+    // Scratch buffers for processBlock, sized in prepareToPlay
+    juce::AudioBuffer<float> lowBuffer;
+    juce::AudioBuffer<float> midBuffer;
+    juce::AudioBuffer<float> highBuffer;
+    juce::AudioBuffer<float> wetBuffer;
+    juce::AudioBuffer<float> sharedInputBuffer;
+    juce::AudioBuffer<float> analysisBuffer;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultibandReverbAudioProcessor)
 };
\ No newline at end of file
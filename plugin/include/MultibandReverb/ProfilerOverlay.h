@@ -0,0 +1,35 @@
+#pragma once
+#include "DspProfiler.h"
+#include <JuceHeader.h>
+
+// ProfilerOverlay.h
+// Drains the processor's DspProfiler and shows min/avg/p99/max per stage over the most recent blocks.
+class ProfilerOverlay : public juce::Component, public juce::Timer {
+  public:
+    explicit ProfilerOverlay(DspProfiler &profilerToUse);
+    ~ProfilerOverlay() override;
+
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+    void timerCallback() override;
+    void visibilityChanged() override;
+
+  private:
+    void exportButtonClicked();
+
+    DspProfiler &profiler;
+
+    // Recent frames feed the on-screen stats, the history keeps the raw timings for export
+    static constexpr size_t statsWindow = 2048;
+    static constexpr size_t maxHistory = 1 << 16;
+
+    std::vector<DspProfiler::Frame> recentFrames;
+    std::vector<DspProfiler::Frame> history;
+    std::array<DspProfiler::StageStats, DspProfiler::NumStages> stats{};
+
+    juce::TextButton exportButton{"Export CSV"};
+    juce::TextButton clearButton{"Clear"};
+    std::unique_ptr<juce::FileChooser> chooser;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+
+#ifndef MBR_REALTIME_CHECKS
+#define MBR_REALTIME_CHECKS 0
+#endif
+
+#if MBR_REALTIME_CHECKS && defined(__linux__) && defined(__GLIBC__)
+#define MBR_REALTIME_INTERPOSE_LIBC 1
+#else
+#define MBR_REALTIME_INTERPOSE_LIBC 0
+#endif
+
+// RealtimeSafety.h
+// Debug-only trap for realtime violations on the audio thread. While a realtime section is open on
+// the current thread, heap allocations, mutex locks and file access abort the process with a stack
+// trace. On Linux the malloc family, pthread_mutex_lock, open, read and fopen are interposed,
+// elsewhere only the global operator new/delete are replaced. The hooks in RealtimeInterpose.cpp
+// replace process-wide functions, so they are only linked into executables: the Standalone and
+// RealtimeStressTest, which ctest runs. A plugin loaded by a host never carries them.
+class RealtimeSafety {
+  public:
+    static void checkAllocation(const char *function);
+    static void checkLock(const char *function);
+    static void checkFileAccess(const char *function);
+
+    // Marks the current thread as running realtime code for the lifetime of the scope
+    class ScopedRealtimeSection {
+      public:
+        ScopedRealtimeSection();
+        ~ScopedRealtimeSection();
+
+        ScopedRealtimeSection(const ScopedRealtimeSection &) = delete;
+        ScopedRealtimeSection &operator=(const ScopedRealtimeSection &) = delete;
+    };
+};
+
+#if MBR_REALTIME_CHECKS
+#define MBR_REALTIME_SECTION() RealtimeSafety::ScopedRealtimeSection mbrRealtimeSection
+#else
+#define MBR_REALTIME_SECTION()
+#endif
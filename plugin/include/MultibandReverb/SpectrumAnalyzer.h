@@ -4,9 +4,17 @@
 class MultibandReverbAudioProcessor;
 
 // SpectrumAnalyzer.h
+// Smoothed line spectrum of the output, or a scrolling spectrogram of the same FFT frames. The
+// spectrogram keeps its history in an image used as a ring of rows: each frame colours one new
+// row through a lookup table and paint draws the ring in two blits, so neither the FFT size nor
+// the history length changes the cost of a frame.
 class SpectrumAnalyzer : public juce::Component, public juce::Timer {
   public:
-    SpectrumAnalyzer();
+    enum class View { Spectrum, Spectrogram };
+
+    static constexpr int defaultFftOrder = 11; // 2048 points
+
+    explicit SpectrumAnalyzer(int order = defaultFftOrder);
     ~SpectrumAnalyzer() override;
 
     void paint(juce::Graphics &g) override;
@@ -16,6 +24,10 @@ class SpectrumAnalyzer : public juce::Component, public juce::Timer {
     void pushBuffer(const float *data, int size);
     void setCrossoverFrequencies(float lowCross, float midCross);
 
+    // Switching to the spectrogram starts its history afresh
+    void setView(View newView);
+    View getView() const { return view; }
+
     // Add processor connection
     void setProcessor(MultibandReverbAudioProcessor *p) { audioProcessor = p; }
 
@@ -25,23 +37,41 @@ class SpectrumAnalyzer : public juce::Component, public juce::Timer {
     void mouseUp(const juce::MouseEvent &e) override;
 
   private:
-    juce::dsp::FFT fft;
-    juce::dsp::WindowingFunction<float> window;
+    // The FFT and window tables are built on the first frame, not when the editor opens
+    const int fftOrder;
+    const int fftSize;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    double sampleRate = 44100.0;
 
     float lowCrossoverFreq = 250.0f;  // Default value
     float midCrossoverFreq = 2500.0f; // Default value
 
-    std::array<float, 2048> fftData;
-    std::array<float, 2048> fifo;
-    std::array<float, 2048> smoothedFFTData; // For temporal smoothing
+    std::vector<float> fftData; // Twice the FFT size, as the transform needs
+    std::vector<float> fifo;
+    std::vector<float> smoothedFFTData; // For temporal smoothing
     int fifoIndex = 0;
     bool nextFFTBlockReady = false;
 
+    static constexpr int refreshHz = 60;
+    static constexpr int reducedRefreshHz = 15;
+    bool isPaused = false; // By the CPU governor
+
     float temporalSmoothing = 0.8f; // Smoothing factor (0 to 1)
     int spectralAveraging = 3;      // Number of bins to average
 
     float getSmoothedValueForFrequency(float freq, float minFreq, float maxFreq, int width);
 
+    // Spectrogram
+    void updateSpectrogramColumns();
+    void writeSpectrogramRow();
+    void drawSpectrogram(juce::Graphics &g);
+
+    View view = View::Spectrum;
+    juce::Image spectrogram; // One row per frame, newest at spectrogramRow and older ones below
+    int spectrogramRow = 0;
+    std::vector<int> columnBins; // First FFT bin of each pixel column, then the end of the last
+
     // Helper methods for crossover dragging
     float getFrequencyForX(float x);
     float getXForFrequency(float freq);
@@ -0,0 +1,80 @@
+#pragma once
+#include <JuceHeader.h>
+
+#ifndef MBR_STARTUP_TIMING
+#define MBR_STARTUP_TIMING 0
+#endif
+
+// StartupTiming.h
+// Logs what each instance costs while a session opens: processor construction, every
+// prepareToPlay, the first processBlock, editor construction and the time from opening the
+// editor to its first complete paint. Lines go to juce::Logger tagged with the instance number, so
+// a template with many instances shows where the time goes. The first processBlock is only
+// stored on the audio thread and logged from a timer. Use the MBR_STARTUP_* macros so the timing
+// disappears when it is compiled out.
+class StartupTiming : private juce::Timer {
+  public:
+    enum Stage { ProcessorConstruction, PrepareToPlay, FirstProcessBlock, EditorConstruction, FirstPaint };
+
+    StartupTiming();
+    ~StartupTiming() override;
+
+    // Not the audio thread
+    void record(Stage stage, juce::int64 ticks) const;
+
+    juce::int64 getCreationTicks() const { return creationTicks; }
+
+    static const char *getStageName(Stage stage);
+
+    // Times the lifetime of the scope
+    class Scope {
+      public:
+        Scope(const StartupTiming &t, Stage s) : timing(t), stage(s), start(juce::Time::getHighResolutionTicks()) {}
+        ~Scope() { timing.record(stage, juce::Time::getHighResolutionTicks() - start); }
+
+      private:
+        const StartupTiming &timing;
+        Stage stage;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(Scope)
+    };
+
+    // Times the scope on the audio thread the first time it is entered, later blocks cost a check
+    class FirstBlockScope {
+      public:
+        explicit FirstBlockScope(StartupTiming &t) : timing(t.hasSeenBlock ? nullptr : &t), start(timing != nullptr ? juce::Time::getHighResolutionTicks() : 0) {}
+
+        ~FirstBlockScope() {
+            if (timing != nullptr) {
+                timing->hasSeenBlock = true;
+                timing->firstBlockTicks.store(juce::Time::getHighResolutionTicks() - start, std::memory_order_release);
+            }
+        }
+
+      private:
+        StartupTiming *timing;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(FirstBlockScope)
+    };
+
+  private:
+    void timerCallback() override;
+
+    const juce::int64 creationTicks;
+    const int instance;
+
+    bool hasSeenBlock = false; // Audio thread
+    std::atomic<juce::int64> firstBlockTicks{-1};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StartupTiming)
+};
+
+#if MBR_STARTUP_TIMING
+#define MBR_STARTUP_SCOPE(timing, stage) StartupTiming::Scope mbrStartupScope(timing, stage)
+#define MBR_STARTUP_FIRST_BLOCK(timing) StartupTiming::FirstBlockScope mbrStartupFirstBlock(timing)
+#else
+#define MBR_STARTUP_SCOPE(timing, stage)
+#define MBR_STARTUP_FIRST_BLOCK(timing)
+#endif
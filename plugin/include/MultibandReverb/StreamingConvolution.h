@@ -0,0 +1,131 @@
+#pragma once
+#include <JuceHeader.h>
+
+// StreamingConvolution.h
+// Convolution with an IR that arrives in pieces. The IR is cut into slots of doubling length,
+// each run by its own JUCE convolution on input delayed by the slot's start, so the head is
+// audible as soon as it is decoded and later slots join the tail as they load.
+class StreamingConvolution {
+  public:
+    // Slot 0 covers the first headLength samples, each later slot is twice as long as the one
+    // before until maxSlotLength, after which slots stay that size. Positions are 64-bit so IRs
+    // longer than 2^31 samples are laid out without truncation.
+    static constexpr juce::int64 headLength = 16384;
+    static constexpr int maxDoublings = 10;
+    static constexpr juce::int64 maxSlotLength = headLength << maxDoublings;
+
+    static juce::int64 getSlotStart(size_t slot);
+    static juce::int64 getSlotLength(size_t slot);
+    static size_t getNumSlots(juce::int64 irLength);
+
+    // The background queue every engine in the process builds its JUCE engines on, shared
+    // through juce::SharedResourcePointer. JUCE's queue takes one producer at a time, and a load
+    // that finds it full is pushed again from Convolution::process on whichever thread runs it.
+    // Loads are only made on the loader thread, which runs the queue itself before it can fill,
+    // so the audio thread and the workers never push.
+    class MessageQueue {
+      public:
+        MessageQueue();
+
+        juce::dsp::ConvolutionMessageQueue &getQueue() { return queue; }
+
+        // Loader thread, before each loadImpulseResponse on a convolution using this queue
+        void reserveLoad();
+
+      private:
+        static constexpr int capacity = 1024;
+
+        juce::dsp::ConvolutionMessageQueue queue{capacity};
+        juce::dsp::Convolution runner{queue}; // Preparing it runs everything queued on the calling thread
+        int loadsSinceRun = 0; // An upper bound on what is queued, the background thread only takes away
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MessageQueue)
+    };
+
+    explicit StreamingConvolution(MessageQueue &queue);
+
+    // Not from the audio thread. Also frees layouts retired by earlier IRs.
+    void prepare(const juce::dsp::ProcessSpec &newSpec);
+    void freeRetiredLayouts();
+
+    // Outputs silence until an IR has been started
+    void process(const juce::dsp::ProcessContextReplacing<float> &context);
+
+    // Audio thread. Slots from maxSlots on fade out and stop being processed, which shortens the
+    // tail, and fade back in once allowed again.
+    void setMaxSlots(size_t newMaxSlots) { maxSlots = newMaxSlots; }
+
+    // Audio thread. Clears the convolution state but keeps the loaded IR, mute the output around it.
+    void reset();
+    bool hasImpulseResponse() const { return current.load(std::memory_order_acquire) != nullptr; }
+
+    // How far an IR is faded in as of the last block, zero until the head of the first one is
+    // heard. The dry signal only makes way for the wet by this much.
+    float getLevel() const { return level.load(std::memory_order_relaxed); }
+
+    // Audio thread. Samples at the processing rate for the input already heard to ring out
+    // through the longest IR in use, zero before any segment has arrived.
+    juce::int64 getTailSamples() const;
+
+    // Loader side, not from the audio thread. Starting an IR swaps in a new layout whose slots
+    // stay silent until their segment is loaded, segments must already be normalised.
+    void beginImpulseResponse(juce::int64 irLength);
+    void loadSegment(size_t slot, juce::AudioBuffer<float> &&segment, double sampleRate);
+
+  private:
+    struct Slot {
+        std::unique_ptr<juce::dsp::Convolution> convolution;
+        std::atomic<bool> isLoaded{false};
+
+        // Audio thread only: a slot is heard once its engine is installed and JUCE's crossfade
+        // away from the initial engine is over, then fades in
+        bool isAudible = false;
+        bool isSuspended = false; // Faded out past maxSlots, its engine is reset before it resumes
+        int settleSamples = 0;
+        float gain = 0.0f;
+    };
+
+    // Everything the audio thread touches for one IR, swapped in as a whole
+    struct Layout {
+        std::vector<std::unique_ptr<Slot>> slots;
+        juce::int64 irLength = 0;
+        std::atomic<double> irSampleRate{0.0}; // Set by the loader with the first segment
+        std::vector<std::vector<float>> history; // Ring of past input feeding the delayed slots
+        size_t historyLength = 0;
+        size_t writePosition = 0;
+        juce::AudioBuffer<float> slotBuffer;
+        juce::AudioBuffer<float> sumBuffer;
+    };
+
+    struct RetiredLayout {
+        std::unique_ptr<Layout> layout;
+        juce::uint64 retiredAtBlock = 0;
+    };
+
+    void prepareLayout(Layout &layout) const;
+    void processLayout(Layout &layout, const juce::dsp::AudioBlock<float> &input, size_t numChannels, size_t numSamples);
+
+    MessageQueue &messageQueue;
+    juce::dsp::ProcessSpec spec{0.0, 0, 0};
+    int settleLength = 0;
+    float fadeStep = 1.0f;
+
+    std::atomic<Layout *> current{nullptr};
+    std::unique_ptr<Layout> owned; // The layout current points at
+    std::vector<RetiredLayout> retired;
+
+    // Audio thread: the layout last processed and the one fading out after an IR change
+    Layout *active = nullptr;
+    Layout *fading = nullptr;
+    float fadingGain = 0.0f;
+    std::atomic<float> level{0.0f};
+    size_t maxSlots = std::numeric_limits<size_t>::max();
+
+    // A retired layout is freed once the audio thread has finished blocks past it and neither
+    // processes it as active, which it keeps while a fade finishes, nor fades it
+    std::atomic<juce::uint64> processedBlocks{0};
+    std::atomic<Layout *> activeLayout{nullptr};
+    std::atomic<Layout *> fadingLayout{nullptr};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(StreamingConvolution)
+};
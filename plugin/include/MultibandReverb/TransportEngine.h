@@ -0,0 +1,69 @@
+// TransportEngine.h
+#pragma once
+#include <JuceHeader.h>
+
+// File playback feeding the processor's input, with no GUI so the processor can run headless.
+// The format manager and read-ahead thread are only set up when the first file is loaded.
+// Change messages are sent when playback starts or stops.
+//
+// The read-ahead thread decodes and resamples into a lock-free FIFO that the audio thread only
+// copies out of, so getNextAudioBlock takes no lock. Seeks and file changes are handed over by
+// the read-ahead thread asking the audio thread to drop what it has buffered.
+class TransportEngine : public juce::ChangeBroadcaster, private juce::TimeSliceClient {
+  public:
+    TransportEngine();
+    ~TransportEngine() override;
+
+    // Message thread
+    bool loadFile(const juce::File &file);
+    bool hasFile() const { return hasSource.load(std::memory_order_acquire); }
+    juce::File getFile() const { return currentFile; }
+    void start();
+    void stop();
+    void setPosition(double seconds);
+    bool isPlaying() const { return playing.load(std::memory_order_relaxed); }
+    double getCurrentPosition() const;
+    double getLengthInSeconds() const { return lengthInSeconds.load(std::memory_order_relaxed); }
+
+    // Audio thread, outputs silence while no file is loaded or playback is stopped
+    void prepareToPlay(int samplesPerBlockExpected, double sampleRate);
+    void getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill);
+    void releaseResources();
+
+  private:
+    int useTimeSlice() override;
+
+    static constexpr int readAheadSamples = 32768;
+    static constexpr int chunkSamples = 2048;
+    static constexpr int numFifoChannels = 2;
+
+    // Handshake for emptying the FIFO, which only its reader may do
+    enum FlushState { FlushIdle, FlushRequested, FlushDone };
+
+    juce::AudioFormatManager formatManager;
+    juce::TimeSliceThread readAheadThread{"Transport Read-Ahead"};
+
+    // Shared by loadFile and the read-ahead thread, never taken on the audio thread
+    juce::CriticalSection sourceLock;
+    std::unique_ptr<juce::AudioFormatReaderSource> readerSource;
+    std::unique_ptr<juce::ResamplingAudioSource> resampler;
+    double sourceSampleRate = 0.0;
+    double resampledRate = 0.0; // Device rate the resampler is set up for, zero forces a flush
+    bool isSourceExhausted = false;
+
+    // Audio at the device rate, written by the read-ahead thread and read by the audio thread
+    juce::AbstractFifo fifo{readAheadSamples};
+    juce::AudioBuffer<float> fifoBuffer;
+
+    juce::File currentFile;
+    std::atomic<bool> hasSource{false};
+    std::atomic<bool> playing{false};
+    std::atomic<double> deviceSampleRate{0.0};
+    std::atomic<double> lengthInSeconds{0.0};
+    std::atomic<double> seekTarget{-1.0};       // Seconds, negative while no seek is pending
+    std::atomic<double> fifoStartSeconds{0.0};  // File position of the first sample after the last flush
+    std::atomic<juce::int64> samplesPlayed{0};  // Since the last flush
+    std::atomic<int> flushState{FlushIdle};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TransportEngine)
+};
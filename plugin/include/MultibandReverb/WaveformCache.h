@@ -0,0 +1,40 @@
+#pragma once
+#include <JuceHeader.h>
+
+// WaveformCache.h
+// Thumbnail cache shared by every waveform view in the process, share it through
+// juce::SharedResourcePointer. Overviews are built on the cache's own background thread and
+// written to disk once complete, so a file that has been seen before draws in full straight
+// away. The key is juce::FileInputSource's hash of the file path and modification time rather
+// than of the content: hashing the content reads the whole file before anything is drawn, the
+// very wait the cache is there to avoid. A file edited in place gets a new modification time and
+// so a new overview, one copied or moved elsewhere is summarised again. The most recently used
+// maxThumbnailsOnDisk overviews are kept.
+class WaveformCache : public juce::AudioThumbnailCache {
+  public:
+    WaveformCache();
+    ~WaveformCache() override;
+
+    juce::AudioFormatManager &getFormatManager() { return formatManager; }
+
+    // Resolution of every overview, so ones built elsewhere (the IR library scan) load into views
+    static constexpr int samplesPerThumbnailSample = 512;
+
+  private:
+    // Called on the cache thread when an overview finishes and on the message thread when a
+    // view is pointed at a file that isn't in memory
+    void saveNewlyFinishedThumbnail(const juce::AudioThumbnailBase &thumbnail, juce::int64 hashCode) override;
+    bool loadNewThumb(juce::AudioThumbnailBase &thumbnail, juce::int64 hashCode) override;
+
+    juce::File getCacheFile(juce::int64 hashCode) const;
+    void pruneDirectory() const;
+
+    static constexpr int maxThumbnailsInMemory = 16;
+    static constexpr int maxThumbnailsOnDisk = 512;
+    static constexpr int pruneSlack = 64; // Sorting the directory waits until this many are over
+
+    juce::File directory;
+    juce::AudioFormatManager formatManager;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformCache)
+};
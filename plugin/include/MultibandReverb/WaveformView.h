@@ -0,0 +1,44 @@
+#pragma once
+#include "WaveformCache.h"
+#include <JuceHeader.h>
+
+// WaveformView.h
+// Min/max overview of an audio file with an optional playhead. The overview is read on the
+// WaveformCache thread and drawn as far as it has got, so long files show up at once and fill
+// in. The rendered waveform is kept as an image so moving the playhead only repaints its strip.
+class WaveformView : public juce::Component, private juce::ChangeListener {
+  public:
+    explicit WaveformView(juce::Colour colour);
+    ~WaveformView() override;
+
+    void setFile(const juce::File &file);
+    void clear();
+
+    // Playhead as a proportion of the file length, negative hides it
+    void setPlayhead(double proportion);
+
+    // Called on click and drag with the position under the mouse as a proportion of the length
+    std::function<void(double)> onScrub;
+
+    void paint(juce::Graphics &g) override;
+    void resized() override;
+    void mouseDown(const juce::MouseEvent &event) override;
+    void mouseDrag(const juce::MouseEvent &event) override;
+
+  private:
+    void changeListenerCallback(juce::ChangeBroadcaster *) override;
+    void renderWaveform(float scale);
+    juce::Rectangle<int> getImageBounds(float scale) const; // The view in physical pixels, at least 1x1
+    juce::Rectangle<int> getPlayheadArea(double proportion) const;
+    void scrubTo(float x);
+
+    juce::SharedResourcePointer<WaveformCache> cache;
+    juce::AudioThumbnail thumbnail;
+    juce::Colour waveformColour;
+
+    juce::Image waveformImage;
+    juce::int64 renderedSamples = -1; // Samples summarised when the image was drawn
+    double playhead = -1.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformView)
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include <JuceHeader.h>
+#include <semaphore>
+
+// WorkerPool.h
+// A few realtime worker threads that help audio threads through a batch of independent jobs.
+// One pool serves every instance in the process, share it through juce::SharedResourcePointer.
+// It never grows past maxWorkers, and a batch that finds the workers busy with another instance's
+// batch runs on the calling thread alone instead of waiting for them. Dispatch only posts
+// semaphores, so it takes no mutex and allocates nothing.
+class WorkerPool {
+  public:
+    using Job = juce::FixedSizeFunction<64, void(size_t)>;
+
+    // No threads are started until an instance reserves some
+    WorkerPool() = default;
+    ~WorkerPool();
+
+    // Not from the audio thread. Starts workers until there are numWorkers, or as many as the
+    // machine allows. They stay until the pool is destroyed.
+    void reserve(size_t numWorkers);
+    size_t getNumWorkers() const { return numStarted.load(std::memory_order_acquire); }
+
+    // Runs job(0) to job(numJobs - 1) on the workers and the calling thread, returns when all are done
+    void run(size_t numJobs, Job job);
+
+    static constexpr size_t maxWorkers = 4;
+
+  private:
+    class Worker : public juce::Thread {
+      public:
+        explicit Worker(WorkerPool &owner) : juce::Thread("Reverb Worker"), pool(owner) {}
+        void run() override;
+
+      private:
+        WorkerPool &pool;
+    };
+
+    void runPendingJobs();
+
+    juce::CriticalSection startLock; // Instances reserve from their own message or host threads
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> numStarted{0};
+
+    std::counting_semaphore<> wake{0};
+    std::counting_semaphore<> done{0};
+
+    // Set while one batch has the workers
+    std::atomic<bool> isBusy{false};
+    Job *currentJob = nullptr;
+    size_t numPendingJobs = 0;
+    std::atomic<size_t> nextJob{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WorkerPool)
+};
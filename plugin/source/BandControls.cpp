@@ -1,8 +1,9 @@
 #include "MultibandReverb/BandControls.h"
+#include "MultibandReverb/IRBrowser.h"
 #include "MultibandReverb/PluginProcessor.h"
 
 //==============================================================================
-BandControls::BandControls(const juce::String &bandName, size_t bandIndex, MultibandReverbAudioProcessor &processor) : name(bandName), bandIdx(bandIndex), processorRef(processor) {
+BandControls::BandControls(const juce::String &bandName, size_t bandIndex, MultibandReverbAudioProcessor &processor) : levelMeter(processor, bandIndex), name(bandName), bandIdx(bandIndex), processorRef(processor) {
     addAndMakeVisible(nameLabel);
     nameLabel.setText(name + " Band", juce::dontSendNotification);
     auto font = juce::Font(16.0f);
@@ -10,7 +11,17 @@ BandControls::BandControls(const juce::String &bandName, size_t bandIndex, Multi
     nameLabel.setFont(font);
 
     addAndMakeVisible(irLoadButton);
+    addAndMakeVisible(irBrowseButton);
+    addAndMakeVisible(irWaveform);
+    addAndMakeVisible(levelMeter);
     irLoadButton.onClick = [this] { loadIRButtonClicked(); };
+    irBrowseButton.onClick = [this] { browseIRButtonClicked(); };
+
+    // Show the IR restored with the session
+    if (const auto irFile = processorRef.getImpulseResponseFile(bandIdx); irFile != juce::File()) {
+        irLoadButton.setButtonText(irFile.getFileNameWithoutExtension());
+        irWaveform.setFile(irFile);
+    }
 
     // Volume Slider setup
     addAndMakeVisible(volumeSlider);
@@ -43,6 +54,58 @@ BandControls::BandControls(const juce::String &bandName, size_t bandIndex, Multi
         }
     };
 
+    // Reverb input mode setup
+    addAndMakeVisible(modeBox);
+    modeBox.addItemList({"Stereo", "Mono Sum", "Mid Only"}, 1);
+
+    addAndMakeVisible(modeLabel);
+    modeLabel.setText("Reverb Input", juce::dontSendNotification);
+    modeLabel.attachToComponent(&modeBox, true);
+
+    modeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(processorRef.parameters, MultibandReverbAudioProcessor::getBandParameterID(bandIdx, "Mode"), modeBox);
+
+    // Reverb engine setup
+    addAndMakeVisible(engineBox);
+    engineBox.addItemList({"Convolution", "FDN"}, 1);
+
+    addAndMakeVisible(engineLabel);
+    engineLabel.setText("Engine", juce::dontSendNotification);
+    engineLabel.attachToComponent(&engineBox, true);
+
+    engineAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(processorRef.parameters, MultibandReverbAudioProcessor::getBandParameterID(bandIdx, "Engine"), engineBox);
+    engineBox.onChange = [this] { updateEngineControls(); };
+
+    addAndMakeVisible(fitButton);
+    fitButton.onClick = [this] {
+        if (!processorRef.fitFdnToImpulseResponse(bandIdx)) {
+            juce::NativeMessageBox::showMessageBoxAsync(juce::MessageBoxIconType::InfoIcon, "No IR Loaded", "Load an IR into this band first to fit the FDN to it.");
+        }
+    };
+
+    // FDN knobs, one per parameter suffix
+    const std::array<std::tuple<juce::Slider *, juce::Label *, const char *, const char *>, 4> fdnControls{{
+        {&decaySlider, &decayLabel, "Decay", " s"},
+        {&sizeSlider, &sizeLabel, "Size", ""},
+        {&densitySlider, &densityLabel, "Density", ""},
+        {&dampingSlider, &dampingLabel, "Damping", ""},
+    }};
+
+    for (auto [slider, label, suffix, unit] : fdnControls) {
+        addAndMakeVisible(*slider);
+        slider->setSliderStyle(juce::Slider::RotaryVerticalDrag);
+        slider->setTextBoxStyle(juce::Slider::TextBoxBelow, false, 50, 18);
+        slider->setTextValueSuffix(unit);
+
+        addAndMakeVisible(*label);
+        label->setText(suffix, juce::dontSendNotification);
+        label->setJustificationType(juce::Justification::centred);
+        label->attachToComponent(slider, false);
+
+        fdnAttachments.push_back(std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(processorRef.parameters, MultibandReverbAudioProcessor::getBandParameterID(bandIdx, suffix), *slider));
+    }
+
+    updateEngineControls();
+
     // Crossover Slider setup
     addAndMakeVisible(crossoverSlider);
     crossoverSlider.setSliderStyle(juce::Slider::RotaryVerticalDrag);
@@ -101,7 +164,15 @@ BandControls::BandControls(const juce::String &bandName, size_t bandIndex, Multi
     };
 }
 
-BandControls::~BandControls() { processorRef.bandReverbs[bandIdx].convolution->reset(); }
+BandControls::~BandControls() = default;
+
+void BandControls::updateEngineControls() {
+    // The FDN knobs only matter while the FDN engine is selected
+    const bool isFdn = engineBox.getSelectedItemIndex() == static_cast<int>(MultibandReverbAudioProcessor::ReverbEngine::Fdn);
+
+    for (auto *slider : {&decaySlider, &sizeSlider, &densitySlider, &dampingSlider})
+        slider->setEnabled(isFdn);
+}
 
 void BandControls::loadIRButtonClicked() {
     fileChooser = std::make_unique<juce::FileChooser>("Select an IR file...", juce::File{}, "*.wav;*.aif;*.aiff");
@@ -113,10 +184,29 @@ void BandControls::loadIRButtonClicked() {
         if (file != juce::File{}) {
             processorRef.loadImpulseResponse(bandIdx, file);
             irLoadButton.setButtonText(file.getFileNameWithoutExtension());
+            irWaveform.setFile(file);
         }
     });
 }
 
+void BandControls::browseIRButtonClicked() {
+    auto browser = std::make_unique<IRBrowser>(processorRef.getImpulseResponseHash(bandIdx));
+
+    // The editor can close while the box is still up
+    browser->onLoad = [safeThis = juce::Component::SafePointer<BandControls>(this)](const juce::File &file) {
+        if (safeThis == nullptr)
+            return;
+
+        safeThis->processorRef.loadImpulseResponse(safeThis->bandIdx, file);
+        safeThis->irLoadButton.setButtonText(file.getFileNameWithoutExtension());
+        safeThis->irWaveform.setFile(file);
+    };
+
+    // Inside the editor rather than on the desktop, which not every host allows a plugin
+    auto *editor = getTopLevelComponent();
+    juce::CallOutBox::launchAsynchronously(std::move(browser), editor->getLocalArea(this, irBrowseButton.getBounds()), editor);
+}
+
 void BandControls::paint(juce::Graphics &g) {
     g.setColour(juce::Colours::white.withAlpha(0.1f));
     g.fillRoundedRectangle(getLocalBounds().toFloat(), 10.0f);
@@ -132,12 +222,19 @@ void BandControls::resized() {
     muteButton.setBounds(topRow);
 
     auto controlArea = area.reduced(10);
-    irLoadButton.setBounds(controlArea.removeFromTop(30));
+    auto irRow = controlArea.removeFromTop(30);
+    irBrowseButton.setBounds(irRow.removeFromRight(70));
+    irRow.removeFromRight(5);
+    irLoadButton.setBounds(irRow);
+    controlArea.removeFromTop(5);
+    irWaveform.setBounds(controlArea.removeFromTop(36));
 
     controlArea.removeFromTop(10);
 
-    // Split remaining area for sliders
-    auto sliderArea = controlArea.removeFromTop(controlArea.getHeight() / 2);
+    // Main sliders, labels sit above them
+    controlArea.removeFromTop(20);
+    auto sliderArea = controlArea.removeFromTop(90);
+    levelMeter.setBounds(sliderArea.removeFromRight(40).withTrimmedTop(-20));
 
     // Position sliders side by side if crossover is visible
     if (crossoverSlider.isVisible()) {
@@ -150,4 +247,23 @@ void BandControls::resized() {
         volumeSlider.setBounds(sliderArea.removeFromLeft(sliderWidth));
         mixSlider.setBounds(sliderArea);
     }
+
+    // Reverb input mode and engine below the sliders, labels on the left
+    controlArea.removeFromTop(10);
+    modeBox.setBounds(controlArea.removeFromTop(24).withTrimmedLeft(80));
+    controlArea.removeFromTop(5);
+
+    auto engineRow = controlArea.removeFromTop(24).withTrimmedLeft(80);
+    fitButton.setBounds(engineRow.removeFromRight(70));
+    engineRow.removeFromRight(5);
+    engineBox.setBounds(engineRow);
+
+    // FDN knobs in a row, labels sit above them
+    controlArea.removeFromTop(25);
+    auto fdnArea = controlArea.removeFromTop(70);
+    auto fdnWidth = fdnArea.getWidth() / 4;
+    decaySlider.setBounds(fdnArea.removeFromLeft(fdnWidth));
+    sizeSlider.setBounds(fdnArea.removeFromLeft(fdnWidth));
+    densitySlider.setBounds(fdnArea.removeFromLeft(fdnWidth));
+    dampingSlider.setBounds(fdnArea);
 }
\ No newline at end of file
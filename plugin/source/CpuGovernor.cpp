@@ -0,0 +1,130 @@
+#include "MultibandReverb/CpuGovernor.h"
+
+//==============================================================================
+CpuGovernor::CpuGovernor() : ticksPerSecond(static_cast<double>(juce::Time::getHighResolutionTicksPerSecond())) {}
+
+CpuGovernor::~CpuGovernor() { stopTimer(); }
+
+void CpuGovernor::prepare(double newSampleRate) {
+    sampleRate = newSampleRate;
+    smoothedLoad = 0.0f;
+    secondsAbove = 0.0;
+    secondsBelow = 0.0;
+    secondsSinceChange = 0.0;
+    load.store(0.0f, std::memory_order_relaxed);
+
+    // Logs tier changes even while no editor is open. Started here rather than on construction,
+    // so instances that are only scanned or never played don't run it.
+    if (!isTimerRunning())
+        startTimerHz(4);
+}
+
+void CpuGovernor::setEnabled(bool shouldBeEnabled) {
+    if (shouldBeEnabled == enabled.load(std::memory_order_relaxed))
+        return;
+
+    enabled.store(shouldBeEnabled, std::memory_order_relaxed);
+    secondsAbove = 0.0;
+    secondsBelow = 0.0;
+
+    if (!shouldBeEnabled && getTier() != Tier::Full)
+        changeTier(Tier::Full, Reason::Disabled);
+}
+
+void CpuGovernor::endBlock(juce::int64 elapsedTicks, int numSamples) {
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    const double blockSeconds = numSamples / sampleRate;
+    const auto blockLoad = static_cast<float>(static_cast<double>(elapsedTicks) / ticksPerSecond / blockSeconds);
+
+    // One pole smoothing with a fixed time constant whatever the block size
+    const auto coefficient = static_cast<float>(std::exp(-blockSeconds / loadSmoothingSeconds));
+    smoothedLoad = blockLoad + coefficient * (smoothedLoad - blockLoad);
+    load.store(smoothedLoad, std::memory_order_relaxed);
+
+    if (!isEnabled())
+        return;
+
+    secondsSinceChange += blockSeconds;
+    secondsAbove = smoothedLoad > stepDownLoad ? secondsAbove + blockSeconds : 0.0;
+    secondsBelow = smoothedLoad < stepUpLoad ? secondsBelow + blockSeconds : 0.0;
+
+    if (secondsSinceChange < holdSeconds)
+        return;
+
+    const auto current = static_cast<int>(getTier());
+
+    if (secondsAbove >= stepDownSeconds && current < numTiers - 1)
+        changeTier(static_cast<Tier>(current + 1), Reason::Pressure);
+    else if (secondsBelow >= stepUpSeconds && current > 0)
+        changeTier(static_cast<Tier>(current - 1), Reason::Headroom);
+}
+
+void CpuGovernor::changeTier(Tier newTier, Reason reason) {
+    const Event event{getTier(), newTier, reason, smoothedLoad, juce::Time::getMillisecondCounter()};
+    tier.store(newTier, std::memory_order_relaxed);
+    secondsAbove = 0.0;
+    secondsBelow = 0.0;
+    secondsSinceChange = 0.0;
+
+    // A full queue drops the event, the tier itself is always current
+    const auto scope = eventFifo.write(1);
+    if (scope.blockSize1 > 0)
+        events[static_cast<size_t>(scope.startIndex1)] = event;
+}
+
+void CpuGovernor::timerCallback() {
+    bool hasNewEvents = false;
+
+    while (eventFifo.getNumReady() > 0) {
+        const auto scope = eventFifo.read(1);
+        const auto &event = events[static_cast<size_t>(scope.startIndex1)];
+
+        juce::Logger::writeToLog("CPU governor: " + describe(event));
+
+        history.push_back(event);
+        if (history.size() > maxHistory)
+            history.pop_front();
+
+        hasNewEvents = true;
+    }
+
+    if (hasNewEvents)
+        sendChangeMessage();
+}
+
+const char *CpuGovernor::getTierName(Tier t) {
+    switch (t) {
+    case Tier::Full:
+        return "Full quality";
+    case Tier::ShortTails:
+        return "Short IR tails";
+    case Tier::MonoLowBand:
+        return "Mono low band";
+    case Tier::ReducedAnalyzer:
+        return "Reduced analyzer";
+    case Tier::AnalyzerPaused:
+        return "Analyzer paused";
+    }
+
+    return "";
+}
+
+juce::String CpuGovernor::describe(const Event &event) {
+    juce::String reason;
+
+    switch (event.reason) {
+    case Reason::Pressure:
+        reason = "load above " + juce::String(juce::roundToInt(stepDownLoad * 100.0f)) + "% for " + juce::String(stepDownSeconds) + " s";
+        break;
+    case Reason::Headroom:
+        reason = "load below " + juce::String(juce::roundToInt(stepUpLoad * 100.0f)) + "% for " + juce::String(stepUpSeconds) + " s";
+        break;
+    case Reason::Disabled:
+        reason = "governor disabled";
+        break;
+    }
+
+    return juce::String(getTierName(event.from)) + " -> " + getTierName(event.to) + " (" + reason + ", smoothed load " + juce::String(juce::roundToInt(event.load * 100.0f)) + "%)";
+}
@@ -0,0 +1,279 @@
+#include "MultibandReverb/Crossover.h"
+
+namespace {
+constexpr double pi = juce::MathConstants<double>::pi;
+constexpr double slopeFadeSeconds = 0.01;
+
+// Taylor series for compile time tables, accurate to double precision for |x| <= pi / 2
+constexpr double taylorSin(double x) {
+    double term = x, sum = x;
+    for (int n = 1; n < 16; ++n) {
+        term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double taylorCos(double x) {
+    double term = 1.0, sum = 1.0;
+    for (int n = 1; n < 16; ++n) {
+        term *= -x * x / static_cast<double>((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+// tan(pi * x) for normalized frequencies x = fc / fs up to just below Nyquist
+constexpr int tanTableSize = 2048;
+constexpr float maxNormalizedFrequency = 0.49f;
+
+constexpr std::array<float, tanTableSize + 1> tanTable = [] {
+    std::array<float, tanTableSize + 1> table{};
+    for (size_t i = 0; i < table.size(); ++i) {
+        const double angle = pi * maxNormalizedFrequency * static_cast<double>(i) / tanTableSize;
+        table[i] = static_cast<float>(taylorSin(angle) / taylorCos(angle));
+    }
+    return table;
+}();
+
+float fastPrewarp(float normalizedFrequency) {
+    const float position = juce::jlimit(0.0f, maxNormalizedFrequency, normalizedFrequency) * (tanTableSize / maxNormalizedFrequency);
+    const auto index = juce::jmin(static_cast<int>(position), tanTableSize - 1);
+    const float fraction = position - static_cast<float>(index);
+    const float a = tanTable[static_cast<size_t>(index)];
+    return a + fraction * (tanTable[static_cast<size_t>(index) + 1] - a);
+}
+
+// Damping 1 / Q of each section: 2 sin((2i + 1) pi / Order), the Butterworth pole pairs of half
+// the order, or a single critically damped section for order 2
+template <int Order>
+constexpr auto dampings = [] {
+    std::array<float, Order == 8 ? 2 : 1> k{};
+    for (size_t i = 0; i < k.size(); ++i)
+        k[i] = static_cast<float>(2.0 * taylorSin((2.0 * static_cast<double>(i) + 1.0) * pi / Order));
+    return k;
+}();
+
+static_assert(dampings<4>[0] > 1.4142f && dampings<4>[0] < 1.4143f);
+
+struct SectionOutput {
+    float low, band, high;
+};
+
+// One TPT state variable step, kg is the damping plus g and h = 1 / (1 + k * g + g * g)
+template <typename Section> inline SectionOutput tick(Section &section, float x, float g, float kg, float h) {
+    const float high = (x - kg * section.z1 - section.z2) * h;
+    const float band = g * high + section.z1;
+    section.z1 = g * high + band;
+    const float low = g * band + section.z2;
+    section.z2 = g * band + low;
+    return {low, band, high};
+}
+
+// The allpass whose difference from the Linkwitz-Riley lowpass is the matching highpass. Order 2
+// needs the first order allpass low - high, higher orders the section's own allpass.
+template <int Order> inline float allpassOutput(const SectionOutput &out, float k) {
+    if constexpr (Order == 2)
+        return out.low - out.high;
+    else
+        return out.low - k * out.band + out.high;
+}
+
+// Calls fn.template operator()<I>() for each I below N, expanded at compile time
+template <size_t N, typename Fn> inline void unroll(Fn &&fn) {
+    [&]<size_t... I>(std::index_sequence<I...>) { (fn.template operator()<I>(), ...); }(std::make_index_sequence<N>{});
+}
+} // namespace
+
+//==============================================================================
+template <int Order> void LinkwitzRileyCrossover<Order>::prepare(const juce::dsp::ProcessSpec &spec) {
+    sampleRate = spec.sampleRate;
+    cutoff.reset(sampleRate, glideSeconds);
+    hasTarget = false;
+    states.assign(spec.numChannels, ChannelState{});
+
+    updateCoefficients(cutoff.getCurrentValue());
+}
+
+template <int Order> void LinkwitzRileyCrossover<Order>::reset() {
+    std::fill(states.begin(), states.end(), ChannelState{});
+    hasTarget = false;
+}
+
+template <int Order> void LinkwitzRileyCrossover<Order>::setTargetFrequency(float frequency) {
+    frequency = juce::jmax(1.0f, frequency);
+
+    if (!hasTarget) {
+        cutoff.setCurrentAndTargetValue(frequency);
+        updateCoefficients(frequency);
+        hasTarget = true;
+    } else {
+        cutoff.setTargetValue(frequency);
+    }
+}
+
+template <int Order> void LinkwitzRileyCrossover<Order>::updateCoefficients(float frequency) {
+    g = fastPrewarp(frequency / static_cast<float>(sampleRate));
+
+    for (size_t i = 0; i < numDampings; ++i) {
+        kg[i] = dampings<Order>[i] + g;
+        h[i] = 1.0f / (1.0f + dampings<Order>[i] * g + g * g);
+    }
+}
+
+template <int Order> void LinkwitzRileyCrossover<Order>::process(const juce::dsp::AudioBlock<float> &input, juce::dsp::AudioBlock<float> &low, juce::dsp::AudioBlock<float> &high, juce::dsp::AudioBlock<float> *compensate) {
+    static_assert(dampings<Order>.size() == numDampings);
+    constexpr auto &k = dampings<Order>;
+
+    const auto numChannels = juce::jmin(input.getNumChannels(), states.size());
+    const auto numSamples = static_cast<int>(input.getNumSamples());
+
+    for (int start = 0; start < numSamples; start += coefficientInterval) {
+        const int chunk = juce::jmin(coefficientInterval, numSamples - start);
+
+        if (cutoff.isSmoothing())
+            updateCoefficients(cutoff.skip(chunk));
+
+        for (size_t channel = 0; channel < numChannels; ++channel) {
+            const auto *in = input.getChannelPointer(channel) + start;
+            auto *lowOut = low.getChannelPointer(channel) + start;
+            auto *highOut = high.getChannelPointer(channel) + start;
+
+            auto state = states[channel];
+
+            for (int i = 0; i < chunk; ++i) {
+                // The first lowpass section also gives the first allpass factor
+                const auto first = tick(state.lowpass[0], in[i], g, kg[0], h[0]);
+                float y = first.low;
+
+                unroll<numLowpassSections - 1>([&]<size_t S>() {
+                    constexpr auto d = (S + 1) % numDampings;
+                    y = tick(state.lowpass[S + 1], y, g, kg[d], h[d]).low;
+                });
+
+                float allpass = allpassOutput<Order>(first, k[0]);
+
+                unroll<numDampings - 1>([&]<size_t S>() { allpass = allpassOutput<Order>(tick(state.allpass[S], allpass, g, kg[S + 1], h[S + 1]), k[S + 1]); });
+
+                // Taking the highpass as allpass minus lowpass keeps the pair exactly complementary
+                lowOut[i] = y;
+                highOut[i] = allpass - y;
+            }
+
+            if (compensate != nullptr && channel < compensate->getNumChannels()) {
+                auto *data = compensate->getChannelPointer(channel) + start;
+
+                for (int i = 0; i < chunk; ++i) {
+                    float x = data[i];
+                    unroll<numDampings>([&]<size_t S>() { x = allpassOutput<Order>(tick(state.compensation[S], x, g, kg[S], h[S]), k[S]); });
+                    data[i] = x;
+                }
+            }
+
+            states[channel] = state;
+        }
+    }
+}
+
+template class LinkwitzRileyCrossover<2>;
+template class LinkwitzRileyCrossover<4>;
+template class LinkwitzRileyCrossover<8>;
+
+//==============================================================================
+template <typename Fn> void ThreeBandCrossover::visitSplit(Slope which, Fn &&fn) {
+    switch (which) {
+    case Slope::LR2:
+        fn(std::get<Split<2>>(splits));
+        break;
+    case Slope::LR4:
+        fn(std::get<Split<4>>(splits));
+        break;
+    case Slope::LR8:
+        fn(std::get<Split<8>>(splits));
+        break;
+    }
+}
+
+void ThreeBandCrossover::prepare(const juce::dsp::ProcessSpec &spec) {
+    // Every slope is kept prepared so switching never allocates
+    std::apply([&](auto &...split) { ((split.lowMid.prepare(spec), split.midHigh.prepare(spec)), ...); }, splits);
+
+    numChannels = spec.numChannels;
+    fadeBuffer.setSize(static_cast<int>(3 * numChannels), static_cast<int>(spec.maximumBlockSize));
+    fadeLength = juce::jmax(1, static_cast<int>(slopeFadeSeconds * spec.sampleRate));
+    isFading = false;
+}
+
+void ThreeBandCrossover::reset() {
+    std::apply([](auto &...split) { ((split.lowMid.reset(), split.midHigh.reset()), ...); }, splits);
+    isFading = false;
+}
+
+void ThreeBandCrossover::setSlope(Slope newSlope) {
+    if (newSlope == slope)
+        return;
+
+    fadingSlope = slope;
+    fadePosition = 0;
+    isFading = true;
+
+    slope = newSlope;
+    visitSplit(slope, [](auto &split) {
+        split.lowMid.reset();
+        split.midHigh.reset();
+    });
+}
+
+void ThreeBandCrossover::setTargetFrequencies(float lowMid, float midHigh) {
+    const auto setTargets = [&](auto &split) {
+        split.lowMid.setTargetFrequency(lowMid);
+        split.midHigh.setTargetFrequency(midHigh);
+    };
+
+    visitSplit(slope, setTargets);
+    if (isFading)
+        visitSplit(fadingSlope, setTargets);
+}
+
+void ThreeBandCrossover::process(const juce::dsp::AudioBlock<float> &input, juce::dsp::AudioBlock<float> &low, juce::dsp::AudioBlock<float> &mid, juce::dsp::AudioBlock<float> &high) {
+    const auto split = [](auto &s, const juce::dsp::AudioBlock<float> &in, juce::dsp::AudioBlock<float> &l, juce::dsp::AudioBlock<float> &m, juce::dsp::AudioBlock<float> &h) {
+        // The first crossover splits into low and mid-high, the second splits mid-high into mid
+        // and high and puts low through its allpass
+        s.lowMid.process(in, l, m);
+        s.midHigh.process(m, m, h, &l);
+    };
+
+    if (!isFading) {
+        visitSplit(slope, [&](auto &s) { split(s, input, low, mid, high); });
+        return;
+    }
+
+    // The old slope gets a copy of the input, which low may overwrite
+    const auto channels = juce::jmin(input.getNumChannels(), numChannels);
+    const auto numSamples = juce::jmin(input.getNumSamples(), static_cast<size_t>(fadeBuffer.getNumSamples()));
+    const auto fadeBlock = juce::dsp::AudioBlock<float>(fadeBuffer);
+    auto oldLow = fadeBlock.getSubsetChannelBlock(0, channels).getSubBlock(0, numSamples);
+    auto oldMid = fadeBlock.getSubsetChannelBlock(numChannels, channels).getSubBlock(0, numSamples);
+    auto oldHigh = fadeBlock.getSubsetChannelBlock(2 * numChannels, channels).getSubBlock(0, numSamples);
+
+    oldLow.copyFrom(input.getSubsetChannelBlock(0, channels).getSubBlock(0, numSamples));
+    visitSplit(fadingSlope, [&](auto &s) { split(s, oldLow, oldLow, oldMid, oldHigh); });
+    visitSplit(slope, [&](auto &s) { split(s, input, low, mid, high); });
+
+    const auto step = 1.0f / static_cast<float>(fadeLength);
+
+    for (auto [band, old] : {std::pair{&low, &oldLow}, std::pair{&mid, &oldMid}, std::pair{&high, &oldHigh}}) {
+        for (size_t channel = 0; channel < channels; ++channel) {
+            auto *out = band->getChannelPointer(channel);
+            const auto *from = old->getChannelPointer(channel);
+
+            for (size_t i = 0; i < numSamples; ++i) {
+                const auto gain = juce::jmin(1.0f, static_cast<float>(fadePosition + static_cast<int>(i) + 1) * step);
+                out[i] = from[i] + (out[i] - from[i]) * gain;
+            }
+        }
+    }
+
+    fadePosition += static_cast<int>(numSamples);
+    isFading = fadePosition < fadeLength;
+}
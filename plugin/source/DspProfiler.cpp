@@ -0,0 +1,118 @@
+#include "MultibandReverb/DspProfiler.h"
+
+//==============================================================================
+DspProfiler::DspProfiler() : frames(static_cast<size_t>(fifoSize)) {}
+
+void DspProfiler::beginBlock(int numSamples) {
+    current.ticks.fill(0);
+    current.numSamples = numSamples;
+    current.sampleRate = sampleRate;
+}
+
+void DspProfiler::endBlock() {
+    // Drop the frame rather than block if the reader has fallen behind
+    if (fifo.getFreeSpace() < 1) {
+        droppedFrames.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto scope = fifo.write(1);
+    frames[static_cast<size_t>(scope.startIndex1)] = current;
+}
+
+int DspProfiler::readFrames(std::vector<Frame> &destination) {
+    const auto numReady = fifo.getNumReady();
+    auto scope = fifo.read(numReady);
+    scope.forEach([&](int index) { destination.push_back(frames[static_cast<size_t>(index)]); });
+    return numReady;
+}
+
+double DspProfiler::ticksToMicros(juce::int64 ticks) { return 1.0e6 * static_cast<double>(ticks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()); }
+
+const char *DspProfiler::getStageName(Stage stage) {
+    switch (stage) {
+    case Transport:
+        return "Transport";
+    case Crossover:
+        return "Crossover";
+    case LowBand:
+        return "Low Band";
+    case MidBand:
+        return "Mid Band";
+    case HighBand:
+        return "High Band";
+    case Mix:
+        return "Mix";
+    case Analyzer:
+        return "Analyzer";
+    case Total:
+        return "Total";
+    default:
+        return "";
+    }
+}
+
+std::array<DspProfiler::StageStats, DspProfiler::NumStages> DspProfiler::computeStats(const std::vector<Frame> &frames) {
+    std::array<StageStats, NumStages> stats{};
+
+    if (frames.empty())
+        return stats;
+
+    std::vector<double> micros(frames.size());
+
+    for (size_t stage = 0; stage < static_cast<size_t>(NumStages); ++stage) {
+        double sum = 0.0;
+        double percentSum = 0.0;
+        double maxPercent = 0.0;
+
+        for (size_t i = 0; i < frames.size(); ++i) {
+            const auto &frame = frames[i];
+            micros[i] = ticksToMicros(frame.ticks[stage]);
+            sum += micros[i];
+
+            // The deadline is the real time duration of the block
+            if (frame.sampleRate > 0.0 && frame.numSamples > 0) {
+                const double deadlineMicros = 1.0e6 * frame.numSamples / frame.sampleRate;
+                const double percent = 100.0 * micros[i] / deadlineMicros;
+                percentSum += percent;
+                maxPercent = juce::jmax(maxPercent, percent);
+            }
+        }
+
+        std::sort(micros.begin(), micros.end());
+
+        auto &s = stats[stage];
+        s.minMicros = micros.front();
+        s.maxMicros = micros.back();
+        s.avgMicros = sum / static_cast<double>(micros.size());
+        s.p99Micros = micros[juce::jmin(micros.size() - 1, (micros.size() * 99) / 100)];
+        s.avgDeadlinePercent = percentSum / static_cast<double>(frames.size());
+        s.maxDeadlinePercent = maxPercent;
+    }
+
+    return stats;
+}
+
+bool DspProfiler::writeCsv(const std::vector<Frame> &frames, juce::OutputStream &out) {
+    juce::String header("block,numSamples,sampleRate");
+    for (int stage = 0; stage < NumStages; ++stage)
+        header << "," << juce::String(getStageName(static_cast<Stage>(stage))).removeCharacters(" ").toLowerCase() << "_us";
+
+    if (!out.writeText(header + "\n", false, false, nullptr))
+        return false;
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const auto &frame = frames[i];
+        juce::String line;
+        line << static_cast<juce::int64>(i) << "," << frame.numSamples << "," << frame.sampleRate;
+
+        for (auto ticks : frame.ticks)
+            line << "," << juce::String(ticksToMicros(ticks), 3);
+
+        if (!out.writeText(line + "\n", false, false, nullptr))
+            return false;
+    }
+
+    out.flush();
+    return true;
+}
@@ -0,0 +1,259 @@
+#include "MultibandReverb/FdnReverb.h"
+#include <bit>
+
+namespace {
+// Mutually prime-ish line lengths in milliseconds at size 1
+constexpr std::array<float, FdnReverb::numLines> baseDelaysMs{31.7f, 37.3f, 41.1f, 43.9f, 53.3f, 59.3f, 67.1f, 73.7f};
+constexpr std::array<float, 4> diffuserDelaysMs{4.7f, 3.6f, 12.7f, 9.3f};
+
+constexpr float minSizeScale = 0.25f;
+constexpr float maxSizeScale = 1.5f;
+constexpr float delayGlide = 0.0005f; // Per sample, size changes glide instead of jumping
+const float lineGain = 1.0f / std::sqrt(static_cast<float>(FdnReverb::numLines));
+
+// Sign of entry (row, column) of the 8x8 Hadamard matrix
+constexpr float hadamardSign(size_t row, size_t column) { return (std::popcount(row & column) % 2) == 0 ? 1.0f : -1.0f; }
+
+constexpr size_t inputRow = 5;
+
+float getSizeScale(float size) { return minSizeScale + (maxSizeScale - minSizeScale) * juce::jlimit(0.0f, 1.0f, size); }
+
+// RT60 from Schroeder backward integration of a mono IR
+float estimateDecayTime(const float *data, int numSamples, double sampleRate) {
+    std::vector<double> energy(static_cast<size_t>(numSamples));
+    double sum = 0.0;
+
+    for (int i = numSamples - 1; i >= 0; --i) {
+        sum += static_cast<double>(data[i]) * data[i];
+        energy[static_cast<size_t>(i)] = sum;
+    }
+
+    if (sum <= 0.0)
+        return 0.0f;
+
+    auto timeAtLevel = [&](double db) -> int {
+        const double threshold = sum * std::pow(10.0, db / 10.0);
+        for (size_t i = 0; i < energy.size(); ++i)
+            if (energy[i] <= threshold)
+                return static_cast<int>(i);
+        return -1;
+    };
+
+    // Fit from -5 dB down to the deepest level the IR reaches
+    const int start = timeAtLevel(-5.0);
+    for (double endDb : {-35.0, -25.0, -15.0}) {
+        const int end = timeAtLevel(endDb);
+        if (start >= 0 && end > start) {
+            const double seconds = static_cast<double>(end - start) / sampleRate;
+            return static_cast<float>(seconds * 60.0 / (-5.0 - endDb));
+        }
+    }
+
+    return 0.0f;
+}
+
+void limitBand(double sampleRate, float &lowFrequency, float &highFrequency) {
+    const float nyquistLimit = static_cast<float>(sampleRate) * 0.45f;
+    lowFrequency = juce::jlimit(10.0f, nyquistLimit, lowFrequency);
+    highFrequency = juce::jlimit(lowFrequency, nyquistLimit, highFrequency);
+}
+
+// Mono copy of the first channel through a Linkwitz-Riley filter
+juce::AudioBuffer<float> filterCopy(const juce::AudioBuffer<float> &source, double sampleRate, juce::dsp::LinkwitzRileyFilterType type, float cutoff) {
+    const int numSamples = source.getNumSamples();
+    juce::AudioBuffer<float> result(1, numSamples);
+    result.copyFrom(0, 0, source, 0, 0, numSamples);
+
+    juce::dsp::LinkwitzRileyFilter<float> filter;
+    filter.prepare({sampleRate, static_cast<juce::uint32>(numSamples), 1});
+    filter.setType(type);
+    filter.setCutoffFrequency(cutoff);
+
+    juce::dsp::AudioBlock<float> block(result);
+    filter.process(juce::dsp::ProcessContextReplacing<float>(block));
+    return result;
+}
+
+juce::AudioBuffer<float> filterBand(const juce::AudioBuffer<float> &source, double sampleRate, float lowFrequency, float highFrequency) {
+    return filterCopy(filterCopy(source, sampleRate, juce::dsp::LinkwitzRileyFilterType::highpass, lowFrequency), sampleRate, juce::dsp::LinkwitzRileyFilterType::lowpass, highFrequency);
+}
+} // namespace
+
+//==============================================================================
+void FdnReverb::prepare(const juce::dsp::ProcessSpec &spec) {
+    sampleRate = spec.sampleRate;
+
+    const auto maxDelay = static_cast<size_t>(baseDelaysMs.back() * maxSizeScale * sampleRate / 1000.0) + 4;
+    lineLength = static_cast<size_t>(juce::nextPowerOfTwo(static_cast<int>(maxDelay)));
+    lineMask = lineLength - 1;
+    delayMemory.assign(numLines * lineLength, 0.0f);
+
+    for (size_t i = 0; i < numDiffusers; ++i)
+        diffuserMemory[i].assign(static_cast<size_t>(diffuserDelaysMs[i] * sampleRate / 1000.0) + 1, 0.0f);
+
+    updateCoefficients();
+    reset();
+}
+
+void FdnReverb::reset() {
+    std::fill(delayMemory.begin(), delayMemory.end(), 0.0f);
+    for (auto &memory : diffuserMemory)
+        std::fill(memory.begin(), memory.end(), 0.0f);
+
+    dampingStates.fill(0.0f);
+    diffuserIndices.fill(0);
+    currentDelays = targetDelays;
+    writeIndex = 0;
+}
+
+void FdnReverb::setParameters(const Parameters &newParameters) {
+    if (newParameters == parameters)
+        return;
+
+    parameters = newParameters;
+    updateCoefficients();
+}
+
+void FdnReverb::updateCoefficients() {
+    const float sizeScale = getSizeScale(parameters.size);
+    const float decaySamples = juce::jmax(0.05f, parameters.decaySeconds) * static_cast<float>(sampleRate);
+
+    for (size_t i = 0; i < numLines; ++i) {
+        targetDelays[i] = baseDelaysMs[i] * sizeScale * static_cast<float>(sampleRate) / 1000.0f;
+
+        // -60 dB after decaySeconds, spread over the passes through this line
+        decayGains[i] = std::pow(10.0f, -3.0f * targetDelays[i] / decaySamples) * lineGain;
+    }
+
+    dampingCoefficient = 0.85f * juce::jlimit(0.0f, 1.0f, parameters.damping);
+    diffusion = 0.75f * juce::jlimit(0.0f, 1.0f, parameters.density);
+}
+
+float FdnReverb::diffuse(float input) {
+    // Series Schroeder allpasses
+    for (size_t i = 0; i < numDiffusers; ++i) {
+        auto &memory = diffuserMemory[i];
+        auto &index = diffuserIndices[i];
+
+        const float delayed = memory[index];
+        const float v = input + diffusion * delayed;
+        input = delayed - diffusion * v;
+        memory[index] = v;
+
+        if (++index >= memory.size())
+            index = 0;
+    }
+
+    return input;
+}
+
+void FdnReverb::hadamard(Frame &frame) {
+    // Fast Walsh-Hadamard transform, the scaling is folded into the decay gains
+    for (size_t half = 1; half < numLines; half *= 2) {
+        for (size_t i = 0; i < numLines; i += half * 2) {
+            for (size_t j = i; j < i + half; ++j) {
+                const float a = frame[j];
+                const float b = frame[j + half];
+                frame[j] = a + b;
+                frame[j + half] = a - b;
+            }
+        }
+    }
+}
+
+void FdnReverb::process(const juce::dsp::ProcessContextReplacing<float> &context) {
+    auto &block = context.getOutputBlock();
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+
+    if (numChannels == 0 || delayMemory.empty())
+        return;
+
+    const float inputScale = lineGain / static_cast<float>(numChannels);
+    const float lengthAsFloat = static_cast<float>(lineLength);
+
+    for (size_t sample = 0; sample < numSamples; ++sample) {
+        float input = 0.0f;
+        for (size_t channel = 0; channel < numChannels; ++channel)
+            input += block.getSample(static_cast<int>(channel), static_cast<int>(sample));
+
+        input = diffuse(input * inputScale);
+
+        alignas(32) Frame delayed;
+        alignas(32) Frame feedback;
+
+        for (size_t i = 0; i < numLines; ++i) {
+            currentDelays[i] += delayGlide * (targetDelays[i] - currentDelays[i]);
+
+            // Linear interpolated read behind the write position
+            const float readPosition = static_cast<float>(writeIndex) + lengthAsFloat - currentDelays[i];
+            const auto index = static_cast<size_t>(readPosition);
+            const float fraction = readPosition - static_cast<float>(index);
+            const float a = delayMemory[(index & lineMask) * numLines + i];
+            const float b = delayMemory[((index + 1) & lineMask) * numLines + i];
+            delayed[i] = a + fraction * (b - a);
+        }
+
+        for (size_t i = 0; i < numLines; ++i) {
+            dampingStates[i] = delayed[i] + dampingCoefficient * (dampingStates[i] - delayed[i]);
+            feedback[i] = dampingStates[i] * decayGains[i];
+        }
+
+        hadamard(feedback);
+
+        // One contiguous frame per sample, a single vector store
+        float *frame = delayMemory.data() + writeIndex * numLines;
+        for (size_t i = 0; i < numLines; ++i)
+            frame[i] = feedback[i] + input * hadamardSign(inputRow, i);
+
+        writeIndex = (writeIndex + 1) & lineMask;
+
+        // Each channel taps the lines through a different Hadamard row so the outputs decorrelate
+        for (size_t channel = 0; channel < numChannels; ++channel) {
+            const size_t row = (channel + 1) % numLines;
+            float out = 0.0f;
+
+            for (size_t i = 0; i < numLines; ++i)
+                out += hadamardSign(row, i) * delayed[i];
+
+            block.setSample(static_cast<int>(channel), static_cast<int>(sample), out * lineGain);
+        }
+    }
+}
+
+FdnReverb::Parameters FdnReverb::fitToImpulseResponse(const juce::AudioBuffer<float> &ir, double irSampleRate, float lowFrequency, float highFrequency, Parameters current) {
+    const int numSamples = ir.getNumSamples();
+
+    if (numSamples < 64 || irSampleRate <= 0.0)
+        return current;
+
+    limitBand(irSampleRate, lowFrequency, highFrequency);
+
+    // The band as the crossover would split it, then its upper half for the damping estimate
+    auto band = filterBand(ir, irSampleRate, lowFrequency, highFrequency);
+    auto upper = filterCopy(band, irSampleRate, juce::dsp::LinkwitzRileyFilterType::highpass, std::sqrt(lowFrequency * highFrequency));
+
+    const float bandDecay = estimateDecayTime(band.getReadPointer(0), numSamples, irSampleRate);
+    const float upperDecay = estimateDecayTime(upper.getReadPointer(0), numSamples, irSampleRate);
+
+    if (bandDecay <= 0.0f)
+        return current;
+
+    current.decaySeconds = juce::jlimit(0.1f, 20.0f, bandDecay);
+
+    if (upperDecay > 0.0f)
+        current.damping = juce::jlimit(0.0f, 0.95f, 1.0f - upperDecay / bandDecay);
+
+    return current;
+}
+
+float FdnReverb::estimateBandDecayTime(const juce::AudioBuffer<float> &ir, double irSampleRate, float lowFrequency, float highFrequency) {
+    const int numSamples = ir.getNumSamples();
+
+    if (numSamples < 64 || irSampleRate <= 0.0)
+        return 0.0f;
+
+    limitBand(irSampleRate, lowFrequency, highFrequency);
+    const auto band = filterBand(ir, irSampleRate, lowFrequency, highFrequency);
+    return estimateDecayTime(band.getReadPointer(0), numSamples, irSampleRate);
+}
@@ -0,0 +1,58 @@
+#include "MultibandReverb/GovernorStatus.h"
+
+//==============================================================================
+GovernorStatus::GovernorStatus(MultibandReverbAudioProcessor &processor) : processorRef(processor) {
+    addAndMakeVisible(enableButton);
+    enableAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(processorRef.parameters, "cpuGovernor", enableButton);
+
+    processorRef.governor.addChangeListener(this);
+    changeListenerCallback(nullptr);
+    startTimerHz(10);
+}
+
+GovernorStatus::~GovernorStatus() {
+    stopTimer();
+    processorRef.governor.removeChangeListener(this);
+}
+
+void GovernorStatus::timerCallback() {
+    load = processorRef.governor.getLoad();
+    tier = processorRef.governor.getTier();
+    repaint();
+}
+
+void GovernorStatus::changeListenerCallback(juce::ChangeBroadcaster *) {
+    const auto &history = processorRef.governor.getHistory();
+
+    if (history.empty()) {
+        lastChange = {};
+        setTooltip({});
+        return;
+    }
+
+    // Newest first in the tooltip
+    const auto now = juce::Time::getMillisecondCounter();
+    juce::StringArray lines;
+
+    for (auto it = history.rbegin(); it != history.rend(); ++it)
+        lines.add(juce::String((now - it->timeMs) / 1000) + " s ago: " + CpuGovernor::describe(*it));
+
+    lastChange = CpuGovernor::describe(history.back());
+    setTooltip(lines.joinIntoString("\n"));
+    repaint();
+}
+
+void GovernorStatus::paint(juce::Graphics &g) {
+    auto area = getLocalBounds().withTrimmedTop(enableButton.getBottom());
+
+    const bool isReduced = tier != CpuGovernor::Tier::Full;
+    g.setColour(isReduced ? juce::Colours::orange : juce::Colours::white.withAlpha(0.7f));
+    g.setFont(12.0f);
+    g.drawText("CPU " + juce::String(juce::roundToInt(load * 100.0f)) + "%  " + CpuGovernor::getTierName(tier), area.removeFromTop(16), juce::Justification::centredLeft);
+
+    g.setColour(juce::Colours::white.withAlpha(0.5f));
+    g.setFont(10.0f);
+    g.drawFittedText(lastChange, area, juce::Justification::topLeft, 2);
+}
+
+void GovernorStatus::resized() { enableButton.setBounds(getLocalBounds().removeFromTop(24)); }
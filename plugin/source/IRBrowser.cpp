@@ -0,0 +1,225 @@
+#include "MultibandReverb/IRBrowser.h"
+
+//==============================================================================
+IRBrowser::IRBrowser(juce::uint64 currentHash) : highlightHash(currentHash) {
+    addAndMakeVisible(folderButton);
+    addAndMakeVisible(rescanButton);
+    addAndMakeVisible(statusLabel);
+    addAndMakeVisible(searchBox);
+    addAndMakeVisible(table);
+    addAndMakeVisible(preview);
+    addAndMakeVisible(loadButton);
+
+    folderButton.onClick = [this] { chooseFolder(); };
+    rescanButton.onClick = [this] { library->rescan(); };
+    loadButton.onClick = [this] { loadRow(table.getSelectedRow()); };
+
+    statusLabel.setFont(juce::Font(12.0f));
+    statusLabel.setColour(juce::Label::textColourId, juce::Colours::white.withAlpha(0.7f));
+
+    searchBox.setTextToShowWhenEmpty("Search", juce::Colours::grey);
+    searchBox.onTextChange = [this] { updateRows(); };
+    searchBox.onReturnKey = [this] { loadRow(rows.empty() ? -1 : juce::jmax(0, table.getSelectedRow())); };
+
+    auto &header = table.getHeader();
+    const auto flags = juce::TableHeaderComponent::defaultFlags;
+    header.addColumn("Name", nameColumn, 230, 80, -1, flags);
+    header.addColumn("Length", lengthColumn, 60, 40, -1, flags);
+    header.addColumn("Rate", rateColumn, 60, 40, -1, flags);
+    header.addColumn("Ch", channelsColumn, 30, 30, -1, flags);
+    header.addColumn("RT60 Low", lowDecayColumn, 70, 40, -1, flags);
+    header.addColumn("RT60 Mid", midDecayColumn, 70, 40, -1, flags);
+    header.addColumn("RT60 High", highDecayColumn, 70, 40, -1, flags);
+    header.setSortColumnId(sortColumn, isSortedForwards);
+
+    table.setRowHeight(20);
+    table.setMultipleSelectionEnabled(false);
+
+    library->addChangeListener(this);
+    changeListenerCallback(nullptr);
+
+    setSize(620, 420);
+}
+
+IRBrowser::~IRBrowser() { library->removeChangeListener(this); }
+
+void IRBrowser::changeListenerCallback(juce::ChangeBroadcaster *) {
+    entries = library->getEntries();
+    updateRows();
+    updateStatus();
+}
+
+void IRBrowser::updateStatus() {
+    const auto folder = library->getFolder();
+    juce::String status;
+
+    if (folder == juce::File())
+        status = "Choose the folder that holds your IRs";
+    else if (library->isScanning())
+        status = "Scanning " + folder.getFileName() + "... " + juce::String(juce::roundToInt(library->getProgress() * 100.0f)) + "%";
+    else
+        status = juce::String(entries.size()) + " IRs in " + folder.getFullPathName();
+
+    statusLabel.setText(status, juce::dontSendNotification);
+}
+
+void IRBrowser::chooseFolder() {
+    folderChooser = std::make_unique<juce::FileChooser>("Select the IR folder...", library->getFolder());
+
+    folderChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories, [this](const juce::FileChooser &fc) {
+        if (const auto folder = fc.getResult(); folder.isDirectory())
+            library->setFolder(folder);
+    });
+}
+
+void IRBrowser::updateRows() {
+    const auto selectedFile = previewFile;
+    const auto search = searchBox.getText().trim();
+
+    rows.clear();
+    for (size_t i = 0; i < entries.size(); ++i)
+        if (search.isEmpty() || entries[i].file.getFileName().containsIgnoreCase(search))
+            rows.push_back(i);
+
+    auto key = [this](size_t index) -> double {
+        const auto &entry = entries[index];
+        switch (sortColumn) {
+        case lengthColumn:
+            return entry.getLengthSeconds();
+        case rateColumn:
+            return entry.sampleRate;
+        case channelsColumn:
+            return entry.numChannels;
+        case lowDecayColumn:
+        case midDecayColumn:
+        case highDecayColumn:
+            return entry.rt60[static_cast<size_t>(sortColumn - lowDecayColumn)];
+        default:
+            return 0.0;
+        }
+    };
+
+    // Stable, so ties keep the path order the snapshot arrives in
+    std::stable_sort(rows.begin(), rows.end(), [&](size_t a, size_t b) {
+        if (sortColumn == nameColumn)
+            return entries[a].file.getFileName().compareNatural(entries[b].file.getFileName()) < 0;
+        return key(a) < key(b);
+    });
+
+    if (!isSortedForwards)
+        std::reverse(rows.begin(), rows.end());
+
+    table.updateContent();
+
+    // Keep the previewed file selected if it is still listed
+    const auto selected = std::find_if(rows.begin(), rows.end(), [&](size_t index) { return entries[index].file == selectedFile; });
+
+    if (selected != rows.end())
+        table.selectRow(static_cast<int>(selected - rows.begin()), true, true);
+    else
+        table.deselectAllRows();
+
+    table.repaint();
+}
+
+int IRBrowser::getNumRows() { return static_cast<int>(rows.size()); }
+
+juce::String IRBrowser::getCellText(const IRLibrary::Entry &entry, int columnId) {
+    auto decay = [](float seconds) { return seconds > 0.0f ? juce::String(seconds, 2) + " s" : juce::String("-"); };
+
+    switch (columnId) {
+    case nameColumn:
+        return entry.file.getFileNameWithoutExtension();
+    case lengthColumn:
+        return juce::String(entry.getLengthSeconds(), 2) + " s";
+    case rateColumn:
+        return juce::String(entry.sampleRate / 1000.0, 1) + " k";
+    case channelsColumn:
+        return juce::String(entry.numChannels);
+    case lowDecayColumn:
+    case midDecayColumn:
+    case highDecayColumn:
+        return decay(entry.rt60[static_cast<size_t>(columnId - lowDecayColumn)]);
+    default:
+        return {};
+    }
+}
+
+void IRBrowser::paintRowBackground(juce::Graphics &g, int row, int, int, bool isSelected) {
+    if (isSelected)
+        g.fillAll(juce::Colours::lightblue.withAlpha(0.3f));
+    else if (row >= 0 && row < getNumRows() && entries[rows[static_cast<size_t>(row)]].hash == highlightHash)
+        g.fillAll(juce::Colours::orange.withAlpha(0.2f));
+    else if (row % 2 == 1)
+        g.fillAll(juce::Colours::white.withAlpha(0.03f));
+}
+
+void IRBrowser::paintCell(juce::Graphics &g, int row, int columnId, int width, int height, bool) {
+    if (row < 0 || row >= getNumRows())
+        return;
+
+    g.setColour(juce::Colours::white.withAlpha(0.85f));
+    g.setFont(13.0f);
+
+    const auto justification = columnId == nameColumn ? juce::Justification::centredLeft : juce::Justification::centredRight;
+    g.drawText(getCellText(entries[rows[static_cast<size_t>(row)]], columnId), 4, 0, width - 8, height, justification, true);
+}
+
+void IRBrowser::sortOrderChanged(int newSortColumnId, bool isForwards) {
+    sortColumn = newSortColumnId;
+    isSortedForwards = isForwards;
+    updateRows();
+}
+
+void IRBrowser::selectedRowsChanged(int lastRowSelected) {
+    if (lastRowSelected < 0 || lastRowSelected >= getNumRows()) {
+        previewFile = juce::File();
+        preview.clear();
+        return;
+    }
+
+    // Reselecting the same file after a refresh leaves the preview alone
+    const auto &file = entries[rows[static_cast<size_t>(lastRowSelected)]].file;
+    if (file != previewFile) {
+        previewFile = file;
+        preview.setFile(file);
+    }
+}
+
+void IRBrowser::cellDoubleClicked(int row, int, const juce::MouseEvent &) { loadRow(row); }
+
+void IRBrowser::returnKeyPressed(int lastRowSelected) { loadRow(lastRowSelected); }
+
+void IRBrowser::loadRow(int row) {
+    if (row < 0 || row >= getNumRows())
+        return;
+
+    const auto file = entries[rows[static_cast<size_t>(row)]].file;
+
+    if (onLoad)
+        onLoad(file);
+
+    if (auto *box = findParentComponentOfClass<juce::CallOutBox>())
+        box->dismiss();
+}
+
+void IRBrowser::resized() {
+    auto area = getLocalBounds().reduced(8);
+
+    auto topRow = area.removeFromTop(24);
+    folderButton.setBounds(topRow.removeFromLeft(80));
+    topRow.removeFromLeft(5);
+    rescanButton.setBounds(topRow.removeFromLeft(70));
+    topRow.removeFromLeft(5);
+    searchBox.setBounds(topRow.removeFromRight(180));
+    statusLabel.setBounds(topRow);
+
+    area.removeFromTop(8);
+    auto bottomRow = area.removeFromBottom(48);
+    loadButton.setBounds(bottomRow.removeFromRight(70).withSizeKeepingCentre(70, 28));
+    bottomRow.removeFromRight(8);
+    preview.setBounds(bottomRow);
+
+    area.removeFromBottom(8);
+    table.setBounds(area);
+}
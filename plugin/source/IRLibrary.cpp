@@ -0,0 +1,261 @@
+#include "MultibandReverb/IRLibrary.h"
+#include "MultibandReverb/FdnReverb.h"
+#include "MultibandReverb/ImpulseResponseLoader.h"
+
+//==============================================================================
+IRLibrary::IRLibrary() : juce::Thread("IR Library Scanner") {
+    indexFile = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("MultibandReverb").getChildFile("IRLibrary.index");
+    startThread(juce::Thread::Priority::low);
+}
+
+IRLibrary::~IRLibrary() {
+    signalThreadShouldExit();
+    notify();
+    stopThread(4000);
+}
+
+void IRLibrary::setFolder(const juce::File &newFolder) {
+    {
+        const juce::ScopedLock sl(lock);
+        if (newFolder == folder)
+            return;
+
+        folder = newFolder;
+        entries.clear();
+    }
+
+    saveIndex();
+    sendChangeMessage();
+    rescan();
+}
+
+juce::File IRLibrary::getFolder() const {
+    const juce::ScopedLock sl(lock);
+    return folder;
+}
+
+void IRLibrary::rescan() {
+    scanRequested = true;
+    notify();
+}
+
+std::vector<IRLibrary::Entry> IRLibrary::getEntries() const {
+    const juce::ScopedLock sl(lock);
+
+    std::vector<Entry> result;
+    result.reserve(entries.size());
+    for (const auto &[path, entry] : entries)
+        result.push_back(entry);
+
+    return result;
+}
+
+void IRLibrary::run() {
+    // Loaded here rather than in the constructor, a large index would hold up opening the editor
+    formatManager.registerBasicFormats();
+    loadIndex();
+    sendChangeMessage();
+
+    // Catch up with files changed while the plugin wasn't running
+    if (getFolder().isDirectory())
+        scanRequested = true;
+
+    while (!threadShouldExit()) {
+        if (!scanRequested.exchange(false)) {
+            wait(-1);
+            continue;
+        }
+
+        scan(getFolder());
+    }
+}
+
+void IRLibrary::scan(const juce::File &folderToScan) {
+    scanning = true;
+    progress = 0.0f;
+    sendChangeMessage();
+
+    const auto files = folderToScan.isDirectory() ? folderToScan.findChildFiles(juce::File::findFiles, true, formatManager.getWildcardForAllFormats()) : juce::Array<juce::File>();
+    std::set<juce::String> found;
+    int numDecoded = 0;
+    auto lastNotify = juce::Time::getMillisecondCounterHiRes();
+
+    for (int i = 0; i < files.size(); ++i) {
+        // A new folder or another rescan starts over, a partial index is still saved below
+        if (threadShouldExit() || scanRequested.load())
+            break;
+
+        Entry entry;
+        entry.file = files.getReference(i);
+        entry.modificationTime = entry.file.getLastModificationTime().toMilliseconds();
+        entry.fileSize = entry.file.getSize();
+
+        const auto path = entry.file.getFullPathName();
+        found.insert(path);
+
+        bool isKnown = false;
+        {
+            const juce::ScopedLock sl(lock);
+            const auto existing = entries.find(path);
+            isKnown = existing != entries.end() && existing->second.modificationTime == entry.modificationTime && existing->second.fileSize == entry.fileSize;
+        }
+
+        if (!isKnown) {
+            const bool isValid = readEntry(entry);
+
+            {
+                const juce::ScopedLock sl(lock);
+                if (folder != folderToScan)
+                    break;
+
+                // Unreadable files stay out of the index and are tried again next scan
+                if (isValid)
+                    entries[path] = entry;
+                else
+                    entries.erase(path);
+            }
+
+            if (++numDecoded % saveInterval == 0)
+                saveIndex();
+        }
+
+        progress = static_cast<float>(i + 1) / static_cast<float>(files.size());
+
+        if (const auto now = juce::Time::getMillisecondCounterHiRes(); now - lastNotify >= notifyIntervalMs) {
+            lastNotify = now;
+            sendChangeMessage();
+        }
+    }
+
+    // Files that have gone are only dropped once the whole folder has been seen
+    if (!threadShouldExit() && !scanRequested.load()) {
+        const juce::ScopedLock sl(lock);
+        if (folder == folderToScan)
+            std::erase_if(entries, [&](const auto &item) { return !found.contains(item.first); });
+    }
+
+    saveIndex();
+
+    scanning = false;
+    progress = 1.0f;
+    sendChangeMessage();
+}
+
+bool IRLibrary::readEntry(Entry &entry) {
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(entry.file));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0 || reader->sampleRate <= 0.0)
+        return false;
+
+    const auto sampleRate = reader->sampleRate;
+    entry.sampleRate = sampleRate;
+    entry.numChannels = static_cast<int>(reader->numChannels);
+    entry.length = reader->lengthInSamples;
+
+    // Hashed exactly as the processor hashes what ImpulseResponseLoader delivers, the sample rate
+    // then the first channel, so a library entry can be matched to a band's loaded IR
+    auto hash = ImpulseResponseLoader::hashBytes(ImpulseResponseLoader::hashSeed, &sampleRate, sizeof(sampleRate));
+
+    juce::AudioBuffer<float> chunk(entry.numChannels, chunkSize);
+    juce::AudioBuffer<float> head(1, static_cast<int>(juce::jmin<juce::int64>(entry.length, maxDecaySamples)));
+
+    juce::AudioThumbnail thumbnail(WaveformCache::samplesPerThumbnailSample, formatManager, *waveformCache);
+    thumbnail.reset(entry.numChannels, sampleRate, entry.length);
+
+    for (juce::int64 start = 0; start < entry.length; start += chunkSize) {
+        if (threadShouldExit())
+            return false;
+
+        const auto numSamples = static_cast<int>(juce::jmin<juce::int64>(chunkSize, entry.length - start));
+        reader->read(&chunk, 0, numSamples, start, true, true);
+
+        hash = ImpulseResponseLoader::hashBytes(hash, chunk.getReadPointer(0), static_cast<size_t>(numSamples) * sizeof(float));
+        thumbnail.addBlock(start, chunk, 0, numSamples);
+
+        if (start < head.getNumSamples())
+            head.copyFrom(0, static_cast<int>(start), chunk, 0, 0, juce::jmin(numSamples, head.getNumSamples() - static_cast<int>(start)));
+    }
+
+    // Zero means no IR on the processor side, which maps it to one in the same way
+    entry.hash = hash == 0 ? 1 : hash;
+
+    entry.rt60 = {FdnReverb::estimateBandDecayTime(head, sampleRate, 20.0f, lowMidFrequency),
+                  FdnReverb::estimateBandDecayTime(head, sampleRate, lowMidFrequency, midHighFrequency),
+                  FdnReverb::estimateBandDecayTime(head, sampleRate, midHighFrequency, 20000.0f)};
+
+    // Keyed as a WaveformView pointed at the file would look it up
+    waveformCache->storeThumb(thumbnail, juce::FileInputSource(entry.file, true).hashCode());
+    return true;
+}
+
+void IRLibrary::loadIndex() {
+    std::unique_ptr<juce::FileInputStream> in(indexFile.createInputStream());
+
+    if (in == nullptr)
+        return;
+
+    const auto tree = juce::ValueTree::readFromStream(*in);
+
+    // An index from another version is rebuilt by the first scan
+    if (!tree.hasType("IRLibrary") || static_cast<int>(tree.getProperty("version")) != indexVersion)
+        return;
+
+    const juce::ScopedLock sl(lock);
+
+    // A folder chosen before the index finished loading wins
+    if (folder != juce::File())
+        return;
+
+    folder = juce::File(tree.getProperty("folder").toString());
+
+    for (const auto &child : tree) {
+        Entry entry;
+        entry.file = juce::File(child.getProperty("path").toString());
+        entry.modificationTime = child.getProperty("modified");
+        entry.fileSize = child.getProperty("size");
+        entry.sampleRate = child.getProperty("sampleRate");
+        entry.numChannels = child.getProperty("channels");
+        entry.length = child.getProperty("length");
+        entry.rt60 = {child.getProperty("rt60Low"), child.getProperty("rt60Mid"), child.getProperty("rt60High")};
+        entry.hash = static_cast<juce::uint64>(static_cast<juce::int64>(child.getProperty("hash")));
+
+        entries[entry.file.getFullPathName()] = entry;
+    }
+}
+
+void IRLibrary::saveIndex() const {
+    juce::ValueTree tree("IRLibrary");
+
+    {
+        const juce::ScopedLock sl(lock);
+        tree.setProperty("version", indexVersion, nullptr);
+        tree.setProperty("folder", folder.getFullPathName(), nullptr);
+
+        for (const auto &[path, entry] : entries) {
+            juce::ValueTree child("IR");
+            child.setProperty("path", path, nullptr);
+            child.setProperty("modified", entry.modificationTime, nullptr);
+            child.setProperty("size", entry.fileSize, nullptr);
+            child.setProperty("sampleRate", entry.sampleRate, nullptr);
+            child.setProperty("channels", entry.numChannels, nullptr);
+            child.setProperty("length", entry.length, nullptr);
+            child.setProperty("rt60Low", entry.rt60[0], nullptr);
+            child.setProperty("rt60Mid", entry.rt60[1], nullptr);
+            child.setProperty("rt60High", entry.rt60[2], nullptr);
+            child.setProperty("hash", static_cast<juce::int64>(entry.hash), nullptr);
+            tree.appendChild(child, nullptr);
+        }
+    }
+
+    if (!indexFile.getParentDirectory().createDirectory())
+        return;
+
+    // Written beside the index and swapped in, so another instance never reads half of it
+    juce::TemporaryFile temp(indexFile);
+
+    if (auto out = temp.getFile().createOutputStream()) {
+        tree.writeToStream(*out);
+        out.reset();
+        temp.overwriteTargetFileWithTemporary();
+    }
+}
@@ -0,0 +1,184 @@
+#include "MultibandReverb/ImpulseResponseLoader.h"
+#include "MultibandReverb/StreamingConvolution.h"
+
+//==============================================================================
+ImpulseResponseLoader::ImpulseResponseLoader() : juce::Thread("IR Loader") { startThread(juce::Thread::Priority::background); }
+
+ImpulseResponseLoader::~ImpulseResponseLoader() {
+    signalThreadShouldExit();
+    notify();
+    stopThread(4000);
+}
+
+bool ImpulseResponseLoader::load(Client &client, size_t bandIndex, const juce::File &file, Priority priority) {
+    {
+        const juce::ScopedLock sl(queueLock);
+
+        // A newer request for the same band supersedes the pending one
+        std::erase_if(pendingJobs, [&](const Job &job) { return job.client == &client && job.bandIndex == bandIndex; });
+
+        if (pendingJobs.size() >= maxPendingJobs) {
+            // Make room by dropping the newest job of the lowest priority below ours
+            auto victim = pendingJobs.end();
+            for (auto it = pendingJobs.begin(); it != pendingJobs.end(); ++it) {
+                if (it->priority < priority && (victim == pendingJobs.end() || it->priority < victim->priority || (it->priority == victim->priority && it->sequence > victim->sequence)))
+                    victim = it;
+            }
+
+            if (victim == pendingJobs.end())
+                return false;
+
+            pendingJobs.erase(victim);
+        }
+
+        pendingJobs.push_back({&client, bandIndex, file, priority, nextSequence++});
+    }
+
+    notify();
+    return true;
+}
+
+void ImpulseResponseLoader::cancelJobsFor(Client &client) {
+    {
+        const juce::ScopedLock sl(queueLock);
+        std::erase_if(pendingJobs, [&](const Job &job) { return job.client == &client; });
+
+        if (runningClient == &client)
+            runningClient = nullptr;
+    }
+
+    // Wait for a delivery that already started
+    const juce::ScopedLock dl(deliveryLock);
+}
+
+bool ImpulseResponseLoader::popNextJob(Job &job) {
+    const juce::ScopedLock sl(queueLock);
+
+    if (pendingJobs.empty())
+        return false;
+
+    // Highest priority first, oldest first within a priority
+    auto next = std::min_element(pendingJobs.begin(), pendingJobs.end(), [](const Job &a, const Job &b) { return a.priority != b.priority ? a.priority > b.priority : a.sequence < b.sequence; });
+
+    job = *next;
+    pendingJobs.erase(next);
+    runningClient = job.client;
+    return true;
+}
+
+bool ImpulseResponseLoader::isSuperseded(const Job &job) {
+    // A newer request for the same band, or a cancelled client, ends the stream early
+    const juce::ScopedLock sl(queueLock);
+    return runningClient != job.client || std::any_of(pendingJobs.begin(), pendingJobs.end(), [&](const Job &pending) { return pending.client == job.client && pending.bandIndex == job.bandIndex; });
+}
+
+bool ImpulseResponseLoader::yieldToHigherPriority(const Job &job, size_t nextSlot, juce::int64 length) {
+    const juce::ScopedLock sl(queueLock);
+
+    // A cancelled client must not be queued again, and a newer job for the band ends the stream
+    // at the next slot anyway
+    if (runningClient != job.client || std::any_of(pendingJobs.begin(), pendingJobs.end(), [&](const Job &pending) { return pending.client == job.client && pending.bandIndex == job.bandIndex; }))
+        return false;
+
+    if (std::none_of(pendingJobs.begin(), pendingJobs.end(), [&](const Job &pending) { return pending.priority > job.priority; }))
+        return false;
+
+    // The rest goes back with its original sequence, ahead of jobs of its priority queued since.
+    // It was only just taken off the queue, so it may go over maxPendingJobs by one.
+    auto rest = job;
+    rest.firstSlot = nextSlot;
+    rest.length = length;
+    pendingJobs.push_back(rest);
+    return true;
+}
+
+template <typename Callback>
+bool ImpulseResponseLoader::deliver(const Job &job, Callback &&callback) {
+    const juce::ScopedLock dl(deliveryLock);
+
+    {
+        // Skip the delivery if the client was cancelled while decoding
+        const juce::ScopedLock sl(queueLock);
+        if (runningClient != job.client)
+            return false;
+    }
+
+    callback(*job.client);
+    return true;
+}
+
+void ImpulseResponseLoader::run() {
+    // Registered here so the first instance doesn't wait for it, only this thread reads files
+    formatManager.registerBasicFormats();
+
+    while (!threadShouldExit()) {
+        Job job;
+
+        if (!popNextJob(job)) {
+            wait(-1);
+            continue;
+        }
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(job.file));
+
+        if (reader == nullptr) {
+            DBG("Failed to read IR file: " << job.file.getFullPathName());
+            continue;
+        }
+
+        DBG("Loading IR file: " << job.file.getFullPathName());
+        DBG("Sample rate: " << reader->sampleRate);
+        DBG("Length in samples: " << reader->lengthInSamples);
+
+        const auto length = reader->lengthInSamples;
+        const auto sampleRate = reader->sampleRate;
+
+        // A resumed stream carries on where it stepped aside, unless the file changed meanwhile
+        if (job.firstSlot > 0 && length != job.length)
+            job.firstSlot = 0;
+
+        if (job.firstSlot == 0 && !deliver(job, [&](Client &client) { client.impulseResponseStarted(job.bandIndex, job.file, length, sampleRate); }))
+            continue;
+
+        // Slots are read in order, each one is at most StreamingConvolution::maxSlotLength long
+        bool isComplete = true;
+        const auto numSlots = StreamingConvolution::getNumSlots(length);
+
+        for (auto slot = job.firstSlot; slot < numSlots; ++slot) {
+            if (threadShouldExit() || isSuperseded(job)) {
+                isComplete = false;
+                break;
+            }
+
+            // After at least one slot, so every turn makes progress
+            if (slot > job.firstSlot && yieldToHigherPriority(job, slot, length)) {
+                isComplete = false;
+                break;
+            }
+
+            const auto start = StreamingConvolution::getSlotStart(slot);
+            const auto numSamples = static_cast<int>(juce::jmin(StreamingConvolution::getSlotLength(slot), length - start));
+
+            juce::AudioBuffer<float> segment(1, numSamples);
+            reader->read(&segment, 0, numSamples, start, true, false);
+
+            if (!deliver(job, [&](Client &client) { client.impulseResponseSegmentLoaded(job.bandIndex, slot, std::move(segment)); })) {
+                isComplete = false;
+                break;
+            }
+        }
+
+        if (isComplete)
+            deliver(job, [&](Client &client) { client.impulseResponseFinished(job.bandIndex); });
+    }
+}
+
+juce::uint64 ImpulseResponseLoader::hashBytes(juce::uint64 hash, const void *data, size_t numBytes) {
+    const auto *bytes = static_cast<const juce::uint8 *>(data);
+    for (size_t i = 0; i < numBytes; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
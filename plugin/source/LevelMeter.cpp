@@ -0,0 +1,49 @@
+#include "MultibandReverb/LevelMeter.h"
+
+//==============================================================================
+LevelMeter::LevelMeter(MultibandReverbAudioProcessor &processor, size_t bandIndex) : processorRef(processor), bandIdx(bandIndex) {
+    // The processor only meters while a meter exists, so a closed editor costs nothing
+    processorRef.addMeteringClient();
+    startTimerHz(30);
+}
+
+LevelMeter::~LevelMeter() {
+    stopTimer();
+    processorRef.removeMeteringClient();
+}
+
+void LevelMeter::timerCallback() {
+    inputLevel = processorRef.getBandInputLevel(bandIdx);
+    reverbLevel = processorRef.getBandReverbLevel(bandIdx);
+    repaint();
+}
+
+void LevelMeter::paint(juce::Graphics &g) {
+    auto area = getLocalBounds().toFloat();
+    const float barWidth = area.getWidth() / 2.0f;
+
+    drawBar(g, area.removeFromLeft(barWidth).reduced(2.0f, 0.0f), inputLevel, "In");
+    drawBar(g, area.reduced(2.0f, 0.0f), reverbLevel, "Rev");
+}
+
+void LevelMeter::drawBar(juce::Graphics &g, juce::Rectangle<float> area, MultibandReverbAudioProcessor::LevelReading level, const juce::String &label) const {
+    auto labelArea = area.removeFromBottom(14.0f);
+    g.setColour(juce::Colours::white.withAlpha(0.7f));
+    g.setFont(11.0f);
+    g.drawText(label, labelArea, juce::Justification::centred);
+
+    g.setColour(juce::Colours::black.withAlpha(0.4f));
+    g.fillRect(area);
+
+    auto toY = [&](float gain) {
+        const float db = juce::jlimit(minDb, maxDb, juce::Decibels::gainToDecibels(gain, minDb));
+        return juce::jmap(db, minDb, maxDb, area.getBottom(), area.getY());
+    };
+
+    // RMS as the bar, peak as a line above it, red once the peak clips
+    g.setColour(juce::Colours::limegreen);
+    g.fillRect(area.withTop(toY(level.rms)));
+
+    g.setColour(level.peak >= 1.0f ? juce::Colours::red : juce::Colours::white);
+    g.fillRect(area.withTop(toY(level.peak)).withHeight(2.0f));
+}
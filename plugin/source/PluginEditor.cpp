@@ -3,14 +3,15 @@
 
 //==============================================================================
 MultibandReverbAudioProcessorEditor::MultibandReverbAudioProcessorEditor(MultibandReverbAudioProcessor &p) : AudioProcessorEditor(&p), processorRef(p) {
-    setSize(800, 700); // Made taller
+    setSize(800, 890); // Made taller for the per-band reverb controls
 
     // Connect analyzer
     processorRef.analyzer = &analyzer;
     analyzer.setProcessor(&processorRef);
 
     // Transport controls
-    addAndMakeVisible(processorRef.transportComponent);
+    addAndMakeVisible(transportView);
+    addAndMakeVisible(governorStatus);
 
     // Set up crossover frequency sliders
 
@@ -37,6 +38,16 @@ MultibandReverbAudioProcessorEditor::MultibandReverbAudioProcessorEditor(Multiba
     sliderAttachments.push_back(std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(processorRef.parameters, "lowCross", lowCrossoverSlider));
     sliderAttachments.push_back(std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(processorRef.parameters, "midCross", midCrossoverSlider));
 
+    // Crossover slope shared by both splits
+    addAndMakeVisible(slopeBox);
+    slopeBox.addItemList({"12 dB/oct (LR2)", "24 dB/oct (LR4)", "48 dB/oct (LR8)"}, 1);
+
+    addAndMakeVisible(slopeLabel);
+    slopeLabel.setText("Crossover Slope", juce::dontSendNotification);
+    slopeLabel.attachToComponent(&slopeBox, true);
+
+    slopeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(processorRef.parameters, "crossoverSlope", slopeBox);
+
     // Add band controls
     addAndMakeVisible(lowBand);
     addAndMakeVisible(midBand);
@@ -44,27 +55,64 @@ MultibandReverbAudioProcessorEditor::MultibandReverbAudioProcessorEditor(Multiba
 
     // Add spectrum analyzer
     addAndMakeVisible(analyzer);
+
+    // Switches the analyzer between the line spectrum and the scrolling spectrogram
+    addAndMakeVisible(spectrogramButton);
+    spectrogramButton.setClickingTogglesState(true);
+    spectrogramButton.onClick = [this] { analyzer.setView(spectrogramButton.getToggleState() ? SpectrumAnalyzer::View::Spectrogram : SpectrumAnalyzer::View::Spectrum); };
+
+#if MBR_ENABLE_PROFILER
+    // Profiler overlay sits on top of the analyzer
+    addAndMakeVisible(profilerButton);
+    addChildComponent(profilerOverlay);
+    profilerButton.setClickingTogglesState(true);
+    profilerButton.onClick = [this] { profilerOverlay.setVisible(profilerButton.getToggleState()); };
+#endif
+
+#if MBR_STARTUP_TIMING
+    processorRef.startupTiming.record(StartupTiming::EditorConstruction, juce::Time::getHighResolutionTicks() - openedTicks);
+#endif
 }
 
 MultibandReverbAudioProcessorEditor::~MultibandReverbAudioProcessorEditor() { processorRef.analyzer = nullptr; }
 
 void MultibandReverbAudioProcessorEditor::paint(juce::Graphics &g) { g.fillAll(juce::Colours::darkgrey); }
 
+#if MBR_STARTUP_TIMING
+void MultibandReverbAudioProcessorEditor::paintOverChildren(juce::Graphics &) {
+    // Called once every child has painted, so this is the first complete frame
+    if (!hasPainted) {
+        hasPainted = true;
+        processorRef.startupTiming.record(StartupTiming::FirstPaint, juce::Time::getHighResolutionTicks() - openedTicks);
+    }
+}
+#endif
+
 void MultibandReverbAudioProcessorEditor::resized() {
     auto bounds = getLocalBounds().reduced(20);
 
     // Transport controls at the very top
-    processorRef.transportComponent.setBounds(bounds.removeFromTop(70));
+    auto transportBounds = bounds.removeFromTop(100);
+#if MBR_ENABLE_PROFILER
+    profilerButton.setBounds(transportBounds.removeFromRight(90).removeFromTop(30).reduced(5));
+#endif
+    governorStatus.setBounds(transportBounds.removeFromRight(220).withTrimmedTop(3));
+    transportView.setBounds(transportBounds);
 
     bounds.removeFromTop(20); // Spacing
 
     // Spectrum analyzer below transport
     analyzer.setBounds(bounds.removeFromTop(200));
+#if MBR_ENABLE_PROFILER
+    profilerOverlay.setBounds(analyzer.getBounds());
+#endif
 
     bounds.removeFromTop(20); // Spacing
 
     // Crossover controls
     auto crossoverBounds = bounds.removeFromTop(60);
+    slopeBox.setBounds(crossoverBounds.withSizeKeepingCentre(200, 24));
+    spectrogramButton.setBounds(crossoverBounds.withWidth(110).withSizeKeepingCentre(110, 24));
     lowCrossoverSlider.setBounds(crossoverBounds.removeFromTop(25));
     midCrossoverSlider.setBounds(crossoverBounds.removeFromTop(25));
 
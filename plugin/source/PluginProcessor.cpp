@@ -3,6 +3,39 @@
 #include "MultibandReverb/BandControls.h"
 #include "MultibandReverb/PluginEditor.h"
 
+namespace {
+// Four independent partial sums so the loop vectorises without relaxed float semantics
+float sumOfSquares(const float *data, int numSamples) {
+    float sums[4] = {};
+    int i = 0;
+
+    for (; i + 4 <= numSamples; i += 4)
+        for (int lane = 0; lane < 4; ++lane)
+            sums[lane] += data[i + lane] * data[i + lane];
+
+    for (; i < numSamples; ++i)
+        sums[0] += data[i] * data[i];
+
+    return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+// Channel types that make a left/right pair for a reverb group
+constexpr std::pair<juce::AudioChannelSet::ChannelType, juce::AudioChannelSet::ChannelType> leftRightPairs[] = {
+    {juce::AudioChannelSet::left, juce::AudioChannelSet::right},
+    {juce::AudioChannelSet::leftCentre, juce::AudioChannelSet::rightCentre},
+    {juce::AudioChannelSet::leftSurround, juce::AudioChannelSet::rightSurround},
+    {juce::AudioChannelSet::leftSurroundSide, juce::AudioChannelSet::rightSurroundSide},
+    {juce::AudioChannelSet::leftSurroundRear, juce::AudioChannelSet::rightSurroundRear},
+    {juce::AudioChannelSet::wideLeft, juce::AudioChannelSet::wideRight},
+    {juce::AudioChannelSet::topFrontLeft, juce::AudioChannelSet::topFrontRight},
+    {juce::AudioChannelSet::topSideLeft, juce::AudioChannelSet::topSideRight},
+    {juce::AudioChannelSet::topRearLeft, juce::AudioChannelSet::topRearRight},
+};
+
+constexpr double rmsWindowSeconds = 0.3;
+constexpr double peakFallDbPerSecond = 20.0;
+} // namespace
+
 juce::AudioProcessorValueTreeState::ParameterLayout MultibandReverbAudioProcessor::createParameterLayout() {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
 
@@ -10,17 +43,37 @@ juce::AudioProcessorValueTreeState::ParameterLayout MultibandReverbAudioProcesso
 
     params.push_back(std::make_unique<juce::AudioParameterFloat>("midCross", "Mid Crossover", juce::NormalisableRange<float>(250.0f, 20000.0f, 1.0f, 0.3f), 2500.0f));
 
+    // Linkwitz-Riley order of both crossovers, see ThreeBandCrossover::Slope
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("crossoverSlope", "Crossover Slope", juce::StringArray{"12 dB/oct", "24 dB/oct", "48 dB/oct"}, 1));
+
+    // Steps quality down through CpuGovernor's tiers when processBlock nears its deadline
+    params.push_back(std::make_unique<juce::AudioParameterBool>("cpuGovernor", "CPU Governor", false));
+
+    // Which channels feed the reverbs on multichannel buses, see ReverbSends
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("reverbSends", "Reverb Sends", juce::StringArray{"All Channels", "Front Only", "First Pair"}, 0));
+
     params.push_back(std::make_unique<juce::AudioParameterFloat>("lowVol", "Low Volume", juce::NormalisableRange<float>(-60.0f, 12.0f, 0.1f), 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("midVol", "Mid Volume", juce::NormalisableRange<float>(-60.0f, 12.0f, 0.1f), 0.0f));
     params.push_back(std::make_unique<juce::AudioParameterFloat>("highVol", "High Volume", juce::NormalisableRange<float>(-60.0f, 12.0f, 0.1f), 0.0f));
 
+    // Reverb input mode and engine per band, see ReverbMode and ReverbEngine
+    const juce::StringArray bandNames{"Low", "Mid", "High"};
+    for (size_t i = 0; i < 3; ++i) {
+        const auto bandName = bandNames[static_cast<int>(i)];
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(getBandParameterID(i, "Mode"), bandName + " Reverb Input", juce::StringArray{"Stereo", "Mono Sum", "Mid Only"}, 0));
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(getBandParameterID(i, "Engine"), bandName + " Reverb Engine", juce::StringArray{"Convolution", "FDN"}, 0));
+
+        // Algorithmic reverb settings, used when the engine is FDN
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getBandParameterID(i, "Decay"), bandName + " FDN Decay", juce::NormalisableRange<float>(0.1f, 20.0f, 0.01f, 0.4f), 2.0f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getBandParameterID(i, "Size"), bandName + " FDN Size", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.5f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getBandParameterID(i, "Density"), bandName + " FDN Density", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.7f));
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(getBandParameterID(i, "Damping"), bandName + " FDN Damping", juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.3f));
+    }
+
     return {params.begin(), params.end()};
 }
 
 MultibandReverbAudioProcessor::MultibandReverbAudioProcessor() : AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true).withOutput("Output", juce::AudioChannelSet::stereo(), true)), parameters(*this, nullptr, "Parameters", createParameterLayout()) {
-    // Initialize crossovers
-    crossovers.resize(2); // We need 2 crossover points for 3 bands
-
     // Initialize reverb bands
     bandReverbs.reserve(3); // Reserve space for 3 bands
     for (int i = 0; i < 3; ++i) {
@@ -30,97 +83,293 @@ MultibandReverbAudioProcessor::MultibandReverbAudioProcessor() : AudioProcessor(
     // Get parameter pointers
     lowCrossoverFreq = parameters.getRawParameterValue("lowCross");
     midCrossoverFreq = parameters.getRawParameterValue("midCross");
+    crossoverSlope = parameters.getRawParameterValue("crossoverSlope");
+    reverbSends = parameters.getRawParameterValue("reverbSends");
+    governorEnabled = parameters.getRawParameterValue("cpuGovernor");
+    bandVolumes = {parameters.getRawParameterValue("lowVol"), parameters.getRawParameterValue("midVol"), parameters.getRawParameterValue("highVol")};
+    for (size_t i = 0; i < bandModes.size(); ++i) {
+        bandModes[i] = parameters.getRawParameterValue(getBandParameterID(i, "Mode"));
+        bandEngines[i] = parameters.getRawParameterValue(getBandParameterID(i, "Engine"));
+        fdnDecays[i] = parameters.getRawParameterValue(getBandParameterID(i, "Decay"));
+        fdnSizes[i] = parameters.getRawParameterValue(getBandParameterID(i, "Size"));
+        fdnDensities[i] = parameters.getRawParameterValue(getBandParameterID(i, "Density"));
+        fdnDampings[i] = parameters.getRawParameterValue(getBandParameterID(i, "Damping"));
+    }
 
-    // Listen to parameter changes
-    parameters.addParameterListener("lowCross", this);
-    parameters.addParameterListener("midCross", this);
+#if MBR_STARTUP_TIMING
+    startupTiming.record(StartupTiming::ProcessorConstruction, juce::Time::getHighResolutionTicks() - startupTiming.getCreationTicks());
+#endif
 }
 
 MultibandReverbAudioProcessor::~MultibandReverbAudioProcessor() {
-    parameters.removeParameterListener("lowCross", this);
-    parameters.removeParameterListener("midCross", this);
+    // The loader is shared with other instances, make sure it never calls back into this one
+    irLoader->cancelJobsFor(*this);
 }
 
 void MultibandReverbAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
+    MBR_STARTUP_SCOPE(startupTiming, StartupTiming::PrepareToPlay);
+
+    // Everything after the host buffer runs on internal sub-blocks of at most this size
+    preparedBlockSize = juce::jmax(1, juce::jmin(getInternalBlockSize(), samplesPerBlock));
+
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = static_cast<uint32>(samplesPerBlock);
+    spec.maximumBlockSize = static_cast<uint32>(preparedBlockSize);
     spec.numChannels = static_cast<uint32>(getTotalNumOutputChannels());
 
+#if MBR_ENABLE_PROFILER
+    profiler.prepare(sampleRate);
+#endif
+
     // Prepare transport
-    transportComponent.prepareToPlay(samplesPerBlock, sampleRate);
+    transport.prepareToPlay(preparedBlockSize, sampleRate);
 
-    // Prepare crossover filters
-    for (auto &crossover : crossovers) {
-        // Configure Linkwitz-Riley filters (4th order, 24 dB/octave)
-        crossover.lowpass.prepare(spec);
-        crossover.lowpass.setType(juce::dsp::LinkwitzRileyFilterType::lowpass);
+    governor.prepare(sampleRate);
+    lowBandWetGain.reset(sampleRate, 0.02);
+    lowBandWetGain.setCurrentAndTargetValue(1.0f);
+    isLowBandMono = false;
+    isLowBandShareable = true;
+    previousLeaders = {0, 1, 2};
+    drainSamples = {};
 
-        crossover.highpass.prepare(spec);
-        crossover.highpass.setType(juce::dsp::LinkwitzRileyFilterType::highpass);
+    for (size_t i = 0; i < bandReverbs.size(); ++i) {
+        previousEngines[i] = static_cast<ReverbEngine>(juce::roundToInt(bandEngines[i]->load()));
+        previousModes[i] = static_cast<ReverbMode>(juce::roundToInt(bandModes[i]->load()));
+        previousRunModes[i] = previousModes[i];
     }
 
-    // Prepare convolution engines
-    for (auto &reverb : bandReverbs) {
-        if (reverb.convolution) {
-            reverb.convolution->prepare(spec);
+    // Allocate band buffers up front so processBlock never does
+    for (auto *bandBuffer : {&lowBuffer, &midBuffer, &highBuffer, &wetBuffer, &sharedInputBuffer})
+        bandBuffer->setSize(getTotalNumOutputChannels(), preparedBlockSize);
+
+    analysisBuffer.setSize(1, preparedBlockSize);
+
+    // Prepare crossover filters, they pick up their frequencies in the first processBlock
+    crossover.prepare(spec);
+
+    prepareReverbGroups(spec);
+
+    // New groups start with the full tail, bring them all in line with the current tier
+    appliedTier = governor.getTier();
+    setTailLimit(appliedTier >= CpuGovernor::Tier::ShortTails);
+}
+
+void MultibandReverbAudioProcessor::prepareReverbGroups(const juce::dsp::ProcessSpec &spec) {
+    const auto numChannels = static_cast<size_t>(spec.numChannels);
+    const auto layout = getChannelLayoutOfBus(false, 0);
+    std::array<std::vector<size_t>, 3> choiceChannels;
+
+    for (size_t channel = 0; channel < numChannels; ++channel) {
+        const auto type = layout.getTypeOfChannel(static_cast<int>(channel));
+
+        if (type != juce::AudioChannelSet::LFE && type != juce::AudioChannelSet::LFE2)
+            choiceChannels[static_cast<size_t>(ReverbSends::All)].push_back(channel);
+
+        if (type == juce::AudioChannelSet::left || type == juce::AudioChannelSet::right || type == juce::AudioChannelSet::centre)
+            choiceChannels[static_cast<size_t>(ReverbSends::FrontOnly)].push_back(channel);
+
+        if (channel < 2)
+            choiceChannels[static_cast<size_t>(ReverbSends::FirstPair)].push_back(channel);
+    }
+
+    if (choiceChannels[static_cast<size_t>(ReverbSends::FrontOnly)].empty())
+        choiceChannels[static_cast<size_t>(ReverbSends::FrontOnly)] = choiceChannels[static_cast<size_t>(ReverbSends::FirstPair)];
+
+    // Only a channel and its left/right partner share a group, left first. Everything else, a
+    // centre, a surround whose partner isn't sent or an ambisonic channel, has a group of its own.
+    const auto getPartner = [&](size_t channel, const std::vector<size_t> &candidates, const std::vector<bool> &isGrouped) -> std::optional<size_t> {
+        const auto type = layout.getTypeOfChannel(static_cast<int>(channel));
+
+        for (const auto &[leftType, rightType] : leftRightPairs) {
+            if (type != leftType && type != rightType)
+                continue;
+
+            const auto partnerType = type == leftType ? rightType : leftType;
+            for (size_t i = 0; i < candidates.size(); ++i)
+                if (!isGrouped[i] && layout.getTypeOfChannel(static_cast<int>(candidates[i])) == partnerType)
+                    return i;
+        }
+
+        return std::nullopt;
+    };
+
+    size_t numGroups = 0;
+
+    for (size_t choice = 0; choice < choiceChannels.size(); ++choice) {
+        const auto &candidates = choiceChannels[choice];
+        auto &sends = sendChannelSets[choice];
+        auto &groups = sendGroupSets[choice];
+        std::vector<bool> isGrouped(candidates.size());
+
+        sends.clear();
+        groups.clear();
+
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            if (isGrouped[i])
+                continue;
+
+            isGrouped[i] = true;
+            groups.push_back({sends.size(), 1});
+
+            if (const auto partner = getPartner(candidates[i], candidates, isGrouped)) {
+                isGrouped[*partner] = true;
+                const bool isLeft = std::any_of(std::begin(leftRightPairs), std::end(leftRightPairs), [&](const auto &pair) { return pair.first == layout.getTypeOfChannel(static_cast<int>(candidates[i])); });
+                sends.push_back(isLeft ? candidates[i] : candidates[*partner]);
+                sends.push_back(isLeft ? candidates[*partner] : candidates[i]);
+                groups.back().numChannels = 2;
+            } else {
+                sends.push_back(candidates[i]);
+            }
         }
+
+        numGroups = juce::jmax(numGroups, groups.size());
     }
 
-    updateCrossoverFrequencies();
+    // Each group convolves at most a stereo pair, the engines cover the choice with the most groups
+    const juce::dsp::ProcessSpec groupSpec{spec.sampleRate, spec.maximumBlockSize, 2};
+
+    std::array<bool, 3> hasNewGroups{};
+
+    {
+        const juce::ScopedLock sl(irLock);
+
+        for (size_t i = 0; i < bandReverbs.size(); ++i) {
+            auto &reverb = bandReverbs[i];
+            reverb.groups.erase(reverb.groups.begin() + static_cast<std::ptrdiff_t>(juce::jmin(numGroups, reverb.groups.size())), reverb.groups.end());
+
+            hasNewGroups[i] = reverb.groups.size() < numGroups;
+            while (reverb.groups.size() < numGroups)
+                reverb.groups.emplace_back(*convolutionQueue);
+
+            for (auto &engines : reverb.groups) {
+                engines.convolution->prepare(groupSpec);
+                engines.fdn.prepare(groupSpec);
+            }
+        }
+    }
+
+    // New groups get the band's IR by streaming it again, which also keeps the groups in step
+    for (size_t i = 0; i < bandReverbs.size(); ++i) {
+        if (const auto file = getImpulseResponseFile(i); hasNewGroups[i] && file.existsAsFile())
+            irLoader->load(*this, i, file, ImpulseResponseLoader::Priority::SessionRestore);
+    }
+
+    // Wide layouts spread their groups over the helper threads shared by every instance
+    if (numGroups >= minParallelGroups)
+        reverbWorkers->reserve(numGroups - 1);
 }
 
-void MultibandReverbAudioProcessor::releaseResources() { transportComponent.releaseResources(); }
+void MultibandReverbAudioProcessor::releaseResources() {
+    transport.releaseResources();
+
+    const juce::ScopedLock sl(irLock);
+    for (auto &reverb : bandReverbs)
+        for (auto &engines : reverb.groups)
+            engines.convolution->freeRetiredLayouts();
+}
+
+bool MultibandReverbAudioProcessor::isBusesLayoutSupported(const BusesLayout &layouts) const {
+    // Any layout works as long as input and output match, bands split every channel
+    const auto &output = layouts.getMainOutputChannelSet();
+    return !output.isDisabled() && output.size() <= maxChannels && layouts.getMainInputChannelSet() == output;
+}
 
 void MultibandReverbAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer, [[maybe_unused]] juce::MidiBuffer &midiMessages) {
     juce::ScopedNoDenormals noDenormals;
+    MBR_REALTIME_SECTION();
+    MBR_PROFILE_BLOCK(profiler, buffer.getNumSamples());
+    MBR_STARTUP_FIRST_BLOCK(startupTiming);
+    const auto blockStart = juce::Time::getHighResolutionTicks();
 
-    // Get audio from transport if it's active
-    juce::AudioSourceChannelInfo info(buffer);
-    transportComponent.getNextAudioBlock(info);
+    governor.setEnabled(governorEnabled->load() >= 0.5f);
+    applyGovernorTier(governor.getTier());
 
+    // Split the host block into internal sub-blocks. Splitting adds no latency and lets any host
+    // block length run on buffers sized once in prepareToPlay.
     const int numSamples = buffer.getNumSamples();
-    const int numChannels = buffer.getNumChannels();
 
-    // Create temporary buffers for band processing
-    juce::AudioBuffer<float> lowBuffer(numChannels, numSamples);
-    juce::AudioBuffer<float> midBuffer(numChannels, numSamples);
-    juce::AudioBuffer<float> highBuffer(numChannels, numSamples);
+    // Metering is skipped entirely while nobody is reading it
+    isMeteringBlock = meteringClients.load(std::memory_order_relaxed) > 0;
+    if (isMeteringBlock) {
+        blockPeaks.fill(0.0f);
+        blockMeanSquares.fill(0.0f);
+    }
 
-    // Copy input to all bands initially
-    for (int channel = 0; channel < numChannels; ++channel) {
-        lowBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
-        midBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+    for (int startSample = 0; startSample < numSamples; startSample += preparedBlockSize) {
+        processSubBlock(buffer, startSample, juce::jmin(preparedBlockSize, numSamples - startSample));
     }
 
-    // Create AudioBlocks for DSP processing
-    juce::dsp::AudioBlock<float> lowBlock(lowBuffer);
-    juce::dsp::AudioBlock<float> midBlock(midBuffer);
-    juce::dsp::AudioBlock<float> highBlock(highBuffer);
+    if (isMeteringBlock)
+        publishLevels(numSamples);
 
-    // Process crossovers and handle solo/mute
-    if (crossovers.size() >= 2) {
-        // Create processing contexts
-        juce::dsp::AudioBlock<float> inputBlock(buffer);
+    governor.endBlock(juce::Time::getHighResolutionTicks() - blockStart, numSamples);
+}
 
-        // First crossover: split into low and mid-high
-        lowBlock.copyFrom(inputBlock);
-        midBlock.copyFrom(inputBlock);
+void MultibandReverbAudioProcessor::applyGovernorTier(CpuGovernor::Tier tier) {
+    const bool wasShort = appliedTier >= CpuGovernor::Tier::ShortTails;
+    const bool isShort = tier >= CpuGovernor::Tier::ShortTails;
+    appliedTier = tier;
 
-        juce::dsp::ProcessContextReplacing<float> lowContext(lowBlock);
-        juce::dsp::ProcessContextReplacing<float> midHighContext(midBlock);
+    if (wasShort != isShort)
+        setTailLimit(isShort);
+}
 
-        crossovers[0].lowpass.process(lowContext);
-        crossovers[0].highpass.process(midHighContext);
+void MultibandReverbAudioProcessor::setTailLimit(bool isShort) {
+    // The slots past the limit fade out or back in on their own
+    for (auto &reverb : bandReverbs)
+        for (auto &engines : reverb.groups)
+            engines.convolution->setMaxSlots(isShort ? shortTailSlots : std::numeric_limits<size_t>::max());
+}
 
-        // Second crossover: split mid-high into mid and high
-        highBlock.copyFrom(midBlock);
+void MultibandReverbAudioProcessor::updateLowBandMono() {
+    const bool wantsMono = appliedTier >= CpuGovernor::Tier::MonoLowBand;
+
+    if (wantsMono != isLowBandMono && lowBandWetGain.getTargetValue() > 0.0f) {
+        lowBandWetGain.setTargetValue(0.0f);
+    } else if (lowBandWetGain.getTargetValue() == 0.0f && !lowBandWetGain.isSmoothing()) {
+        // Silent now. Going back to stereo clears the engines, the second channel still holds
+        // input from before the switch, and the tail restarts behind the fade in.
+        if (wantsMono != isLowBandMono && !wantsMono) {
+            for (auto &engines : bandReverbs[0].groups) {
+                engines.convolution->reset();
+                engines.fdn.reset();
+            }
+        }
 
-        juce::dsp::ProcessContextReplacing<float> midContext(midBlock);
-        juce::dsp::ProcessContextReplacing<float> highContext(highBlock);
+        isLowBandMono = wantsMono;
+        lowBandWetGain.setTargetValue(1.0f);
+    }
+}
 
-        crossovers[1].lowpass.process(midContext);
-        crossovers[1].highpass.process(highContext);
+void MultibandReverbAudioProcessor::processSubBlock(juce::AudioBuffer<float> &buffer, int startSample, int numSamples) {
+    // Get audio from transport if it's active
+    {
+        MBR_PROFILE_STAGE(profiler, DspProfiler::Transport);
+        juce::AudioSourceChannelInfo info(&buffer, startSample, numSamples);
+        transport.getNextAudioBlock(info);
+    }
+
+    const auto numChannels = juce::jmin(static_cast<size_t>(buffer.getNumChannels()), static_cast<size_t>(lowBuffer.getNumChannels()));
+    const auto length = static_cast<size_t>(numSamples);
+
+    // Views into the host buffer and the band buffers allocated in prepareToPlay
+    auto outputBlock = juce::dsp::AudioBlock<float>(buffer).getSubsetChannelBlock(0, numChannels).getSubBlock(static_cast<size_t>(startSample), length);
+    auto lowBlock = juce::dsp::AudioBlock<float>(lowBuffer).getSubsetChannelBlock(0, numChannels).getSubBlock(0, length);
+    auto midBlock = juce::dsp::AudioBlock<float>(midBuffer).getSubsetChannelBlock(0, numChannels).getSubBlock(0, length);
+    auto highBlock = juce::dsp::AudioBlock<float>(highBuffer).getSubsetChannelBlock(0, numChannels).getSubBlock(0, length);
+    auto wetBlock = juce::dsp::AudioBlock<float>(wetBuffer).getSubsetChannelBlock(0, numChannels).getSubBlock(0, length);
+
+    // Process crossovers and handle solo/mute
+    {
+        MBR_PROFILE_STAGE(profiler, DspProfiler::Crossover);
+        updateCrossoverFrequencies();
+        crossover.process(outputBlock, lowBlock, midBlock, highBlock);
+    }
+
+    if (isMeteringBlock) {
+        accumulateLevel(0, lowBlock);
+        accumulateLevel(1, midBlock);
+        accumulateLevel(2, highBlock);
     }
 
     // Process each band through its reverb and handle solo/mute
@@ -132,87 +381,388 @@ void MultibandReverbAudioProcessor::processBlock(juce::AudioBuffer<float> &buffe
         }
     }
 
-    // Clear the output buffer before mixing
-    buffer.clear();
+    // Clear the output before mixing
+    outputBlock.clear();
+
+    std::array<juce::dsp::AudioBlock<float> *, 3> bandBlocks{&lowBlock, &midBlock, &highBlock};
+    std::array<bool, 3> isAudible{};
+    std::array<float, 3> volumeGains{};
+    std::array<float, 3> wetGains{};
+    std::array<ReverbMode, 3> modes{};
+    std::array<ReverbEngine, 3> engines{};
 
-    // Mix bands based on solo/mute state
+    // Mix the dry part of each band based on solo/mute state
     for (size_t i = 0; i < bandReverbs.size(); ++i) {
         auto &reverb = bandReverbs[i];
-        juce::AudioBuffer<float> *bandBuffer = nullptr;
+        modes[i] = static_cast<ReverbMode>(juce::roundToInt(bandModes[i]->load()));
+        engines[i] = static_cast<ReverbEngine>(juce::roundToInt(bandEngines[i]->load()));
+
+        if (engines[i] == ReverbEngine::Fdn) {
+            const FdnReverb::Parameters fdnParameters{fdnDecays[i]->load(), fdnSizes[i]->load(), fdnDensities[i]->load(), fdnDampings[i]->load()};
+            for (auto &group : reverb.groups)
+                group.fdn.setParameters(fdnParameters);
+        }
 
         // Skip if muted or if any band is soloed and this one isn't
         if (reverb.isMuted || (anySoloed && !reverb.isSoloed)) {
             continue;
         }
 
-        switch (i) {
-        case 0:
-            bandBuffer = &lowBuffer;
-            break;
-        case 1:
-            bandBuffer = &midBuffer;
-            break;
-        case 2:
-            bandBuffer = &highBuffer;
-            break;
-        default:
-            break;
+        MBR_PROFILE_STAGE(profiler, DspProfiler::Mix);
+        isAudible[i] = true;
+
+        // Get and apply volume for this band
+        float volumeDb = bandVolumes[i]->load();
+        float volumeGain = juce::Decibels::decibelsToGain(volumeDb);
+
+        volumeGains[i] = volumeGain;
+        wetGains[i] = hasReverb(i, engines[i]) ? reverb.mix * volumeGain : 0.0f;
+    }
+
+    // Only the send channels feed the reverbs, in left/right pairs or single channels that each
+    // have their own engines. A host buffer narrower than the prepared layout gets no reverb.
+    const auto sendsIndex = static_cast<size_t>(juce::jlimit(0, 2, juce::roundToInt(reverbSends->load())));
+    const auto &sendChannels = sendChannelSets[sendsIndex];
+    const auto &sendGroups = sendGroupSets[sendsIndex];
+    const bool isFullWidth = numChannels == static_cast<size_t>(lowBuffer.getNumChannels());
+    const auto numSends = isFullWidth ? sendChannels.size() : 0;
+    const auto numGroups = isFullWidth ? sendGroups.size() : 0;
+    auto compactWetBlock = wetBlock.getSubsetChannelBlock(0, numSends);
+
+    updateLowBandMono();
+    const bool isLowBandDucked = lowBandWetGain.isSmoothing() || lowBandWetGain.getTargetValue() < 1.0f;
+    bool isLowBandWetRamped = false;
+
+    // The mono switch and its duck only concern the low band, so it convolves alone until it is
+    // back in stereo at full level
+    isLowBandShareable = !isLowBandMono && !lowBandWetGain.isSmoothing() && lowBandWetGain.getTargetValue() == 1.0f;
+
+    // Taken once per sub-block, the loader thread may change the hashes in between
+    std::array<size_t, 3> leaders{};
+    std::array<ReverbMode, 3> runModes{};
+    for (size_t i = 0; i < leaders.size(); ++i) {
+        leaders[i] = getConvolutionLeader(i, modes, engines);
+        runModes[i] = i == 0 && isLowBandMono ? ReverbMode::MonoSum : modes[i];
+    }
+
+    for (size_t i = 0; i < bandReverbs.size(); ++i) {
+        auto &groups = bandReverbs[i].groups;
+
+        // A new engine or input mode starts from silence, the engines' state belongs to the old
+        // setting and would otherwise replay the next time it is chosen
+        if (engines[i] != previousEngines[i] || modes[i] != previousModes[i]) {
+            for (auto &group : groups) {
+                group.convolution->reset();
+                group.fdn.reset();
+            }
+            drainSamples[i] = 0;
+        } else if (previousLeaders[i] == i && leaders[i] != i && !groups.empty()) {
+            // A band that joins another band's convolution keeps its own running on silence until
+            // what it already heard has rung out, the two add up to what one engine would play
+            drainSamples[i] = groups.front().convolution->getTailSamples();
+            drainModes[i] = previousRunModes[i];
         }
+    }
 
-        if (bandBuffer != nullptr) {
-            if (reverb.convolution) {
-                // Create wet buffer for reverb
-                juce::AudioBuffer<float> wetBuffer(numChannels, numSamples);
-                for (int channel = 0; channel < numChannels; ++channel) {
-                    wetBuffer.copyFrom(channel, 0, *bandBuffer, channel, 0, numSamples);
-                }
+    // The dry part only makes way for the wet on the send channels the wet comes back on, and
+    // only as far as the engine the band is heard through has faded its IR in. Channels outside
+    // the sends, LFE among them, keep the full dry band, and a band doesn't dip while its IR is
+    // still loading. Around a mono switch the low band's dry part follows the duck on its wet, so
+    // the two still add up to the band's volume.
+    for (size_t i = 0; i < bandReverbs.size(); ++i) {
+        if (!isAudible[i])
+            continue;
 
-                // Process through convolution
-                juce::dsp::AudioBlock<float> wetBlock(wetBuffer);
-                juce::dsp::ProcessContextReplacing<float> wetContext(wetBlock);
-                reverb.convolution->process(wetContext);
+        MBR_PROFILE_STAGE(profiler, DspProfiler::Mix);
+        outputBlock.addProductOf(*bandBlocks[i], volumeGains[i]);
 
-                // Mix wet and dry
-                const float wetGain = reverb.mix;
-                const float dryGain = 1.0f - wetGain;
+        const auto dryReduction = wetGains[i] * getReverbLevel(leaders[i], engines[i]);
+        if (dryReduction == 0.0f)
+            continue;
 
-                for (int channel = 0; channel < numChannels; ++channel) {
-                    auto *dry = bandBuffer->getWritePointer(channel);
-                    auto *wet = wetBuffer.getReadPointer(channel);
+        for (size_t send = 0; send < numSends; ++send) {
+            auto *output = outputBlock.getChannelPointer(sendChannels[send]);
+            const auto *input = bandBlocks[i]->getChannelPointer(sendChannels[send]);
+
+            if (i == 0 && isLowBandDucked) {
+                // A copy, the smoother itself advances once when the wet is ducked below
+                auto duck = lowBandWetGain;
+                for (size_t sample = 0; sample < length; ++sample)
+                    output[sample] -= dryReduction * duck.getNextValue() * input[sample];
+            } else {
+                juce::FloatVectorOperations::addWithMultiply(output, input, -dryReduction, numSamples);
+            }
+        }
+    }
 
-                    for (int sample = 0; sample < numSamples; ++sample) {
-                        dry[sample] = dry[sample] * dryGain + wet[sample] * wetGain;
-                    }
+    // Convolution is linear, so bands sharing an IR and input mode are scaled by their wet gains,
+    // summed and convolved once by the engine of the lowest band in the group. FDN bands always
+    // lead their own group.
+    for (size_t i = 0; i < bandReverbs.size(); ++i) {
+        if (numGroups == 0 || !hasReverb(i, engines[i]) || leaders[i] != i) {
+            continue;
+        }
+
+        // Back on its own engines. One still draining holds just the tail of the band's own input
+        // and carries on from it, one left idle holds older input and starts from silence.
+        if (previousLeaders[i] != i) {
+            const bool keepsTail = drainSamples[i] > 0 && drainModes[i] == runModes[i];
+            drainSamples[i] = 0;
+
+            if (!keepsTail) {
+                for (auto &group : bandReverbs[i].groups) {
+                    group.convolution->reset();
+                    group.fdn.reset();
                 }
             }
+        }
 
-            // Get and apply volume for this band
-            juce::String volParamID = i == 0 ? "lowVol" : (i == 1 ? "midVol" : "highVol");
-            float volumeDb = *parameters.getRawParameterValue(volParamID);
-            float volumeGain = juce::Decibels::decibelsToGain(volumeDb);
+        MBR_PROFILE_STAGE(profiler, static_cast<DspProfiler::Stage>(DspProfiler::LowBand + static_cast<int>(i)));
+        bool hasInput = false;
 
-            // Add the processed band to the output with volume applied
-            for (int channel = 0; channel < numChannels; ++channel) {
-                buffer.addFrom(channel, 0, *bandBuffer, channel, 0, numSamples, volumeGain);
+        reverbJob.memberGains = {};
+        for (size_t member = i; member < bandReverbs.size(); ++member) {
+            if (isAudible[member] && leaders[member] == i) {
+                reverbJob.memberGains[member] = wetGains[member];
+                hasInput = true;
             }
         }
+
+        if (!hasInput || bandReverbs[i].groups.size() < numGroups) {
+            continue;
+        }
+
+        reverbJob.leader = i;
+        reverbJob.length = length;
+        reverbJob.sendChannels = &sendChannels;
+        reverbJob.sendGroups = &sendGroups;
+        reverbJob.bandBlocks = {bandBlocks[0], bandBlocks[1], bandBlocks[2]};
+        reverbJob.mode = runModes[i];
+        reverbJob.engine = engines[i];
+        runReverbGroups(numGroups);
+
+        // The low band follows the duck around a mono switch, it has no group members meanwhile
+        if (i == 0 && isLowBandDucked) {
+            lowBandWetGain.applyGain(wetBuffer, numSamples);
+            isLowBandWetRamped = true;
+        }
+
+        // Add the wet signal back onto the channels it came from
+        for (size_t send = 0; send < numSends; ++send)
+            juce::FloatVectorOperations::add(outputBlock.getChannelPointer(sendChannels[send]), compactWetBlock.getChannelPointer(send), numSamples);
+
+        if (isMeteringBlock) {
+            for (size_t member = i; member < bandReverbs.size(); ++member)
+                if (isAudible[member] && leaders[member] == i)
+                    accumulateLevel(reverbMeterOffset + member, compactWetBlock);
+        }
+    }
+
+    // Draining engines run on silent input, their output is the rest of the tail
+    for (size_t i = 0; i < bandReverbs.size(); ++i) {
+        if (drainSamples[i] <= 0 || leaders[i] == i || !isAudible[i] || numGroups == 0 || bandReverbs[i].groups.size() < numGroups)
+            continue;
+
+        MBR_PROFILE_STAGE(profiler, static_cast<DspProfiler::Stage>(DspProfiler::LowBand + static_cast<int>(i)));
+        reverbJob.leader = i;
+        reverbJob.length = length;
+        reverbJob.sendChannels = &sendChannels;
+        reverbJob.sendGroups = &sendGroups;
+        reverbJob.bandBlocks = {bandBlocks[0], bandBlocks[1], bandBlocks[2]};
+        reverbJob.memberGains = {};
+        reverbJob.mode = drainModes[i];
+        reverbJob.engine = ReverbEngine::Convolution;
+        runReverbGroups(numGroups);
+
+        for (size_t send = 0; send < numSends; ++send)
+            juce::FloatVectorOperations::add(outputBlock.getChannelPointer(sendChannels[send]), compactWetBlock.getChannelPointer(send), numSamples);
+
+        drainSamples[i] -= numSamples;
     }
 
-    // Now push the processed audio to the analyzer
-    if (analyzer != nullptr) {
-        float analysisBuf[2048];
-        const float *channelData = buffer.getReadPointer(0);
+    previousLeaders = leaders;
+    previousEngines = engines;
+    previousModes = modes;
+    previousRunModes = runModes;
 
-        if (buffer.getNumChannels() > 1) {
-            const float *channel2Data = buffer.getReadPointer(1);
-            for (int i = 0; i < numSamples; ++i) {
-                analysisBuf[i] = (channelData[i] + channel2Data[i]) * 0.5f;
-            }
+    if (!isLowBandWetRamped)
+        lowBandWetGain.skip(numSamples);
+
+    if (isMeteringBlock)
+        accumulateLevel(outputMeter, outputBlock);
+
+    // Now push the processed audio to the analyzer, unless the governor has paused it
+    if (analyzer != nullptr && numChannels > 0 && appliedTier < CpuGovernor::Tier::AnalyzerPaused) {
+        MBR_PROFILE_STAGE(profiler, DspProfiler::Analyzer);
+        auto *analysisData = analysisBuffer.getWritePointer(0);
+        const float *channelData = outputBlock.getChannelPointer(0);
+
+        if (numChannels > 1) {
+            juce::FloatVectorOperations::add(analysisData, channelData, outputBlock.getChannelPointer(1), numSamples);
+            juce::FloatVectorOperations::multiply(analysisData, 0.5f, numSamples);
         } else {
-            std::memcpy(analysisBuf, channelData, numSamples * sizeof(float));
+            juce::FloatVectorOperations::copy(analysisData, channelData, numSamples);
         }
 
-        analyzer->pushBuffer(analysisBuf, numSamples);
+        analyzer->pushBuffer(analysisData, numSamples);
+    }
+}
+
+void MultibandReverbAudioProcessor::runReverbGroups(size_t numGroups) {
+    if (numGroups >= minParallelGroups && reverbWorkers->getNumWorkers() > 0) {
+        reverbWorkers->run(numGroups, [this](size_t group) { processReverbGroup(group); });
+    } else {
+        for (size_t group = 0; group < numGroups; ++group)
+            processReverbGroup(group);
+    }
+}
+
+void MultibandReverbAudioProcessor::processReverbGroup(size_t group) {
+    // Runs on the audio thread or a reverb worker, each group only touches its own channels
+    const auto &job = reverbJob;
+    const auto firstSend = (*job.sendGroups)[group].firstSend;
+    const auto numGroupChannels = (*job.sendGroups)[group].numChannels;
+    const auto numSamples = static_cast<int>(job.length);
+
+    auto inputBlock = juce::dsp::AudioBlock<float>(sharedInputBuffer).getSubsetChannelBlock(firstSend, numGroupChannels).getSubBlock(0, job.length);
+    auto groupWetBlock = juce::dsp::AudioBlock<float>(wetBuffer).getSubsetChannelBlock(firstSend, numGroupChannels).getSubBlock(0, job.length);
+
+    inputBlock.clear();
+
+    for (size_t member = 0; member < job.bandBlocks.size(); ++member) {
+        if (job.memberGains[member] == 0.0f)
+            continue;
+
+        for (size_t channel = 0; channel < numGroupChannels; ++channel) {
+            const auto *source = job.bandBlocks[member]->getChannelPointer((*job.sendChannels)[firstSend + channel]);
+            juce::FloatVectorOperations::addWithMultiply(inputBlock.getChannelPointer(channel), source, job.memberGains[member], numSamples);
+        }
+    }
+
+    processBandReverb(bandReverbs[job.leader].groups[group], inputBlock, groupWetBlock, job.mode, job.engine);
+}
+
+void MultibandReverbAudioProcessor::processBandReverb(ReverbEngines &reverb, const juce::dsp::AudioBlock<float> &bandBlock, juce::dsp::AudioBlock<float> &wetBlock, ReverbMode mode, ReverbEngine engine) {
+    const auto numChannels = bandBlock.getNumChannels();
+    const auto numSamples = static_cast<int>(bandBlock.getNumSamples());
+
+    auto runEngine = [&reverb, engine](juce::dsp::AudioBlock<float> &block) {
+        juce::dsp::ProcessContextReplacing<float> context(block);
+
+        if (engine == ReverbEngine::Fdn)
+            reverb.fdn.process(context);
+        else
+            reverb.convolution->process(context);
+    };
+
+    // A single channel has nothing to sum, and mid/side is only defined for a stereo pair. Groups
+    // only pair a left channel with its right one.
+    if (numChannels < 2)
+        mode = ReverbMode::Stereo;
+    else if (mode == ReverbMode::MidOnly && numChannels != 2)
+        mode = ReverbMode::MonoSum;
+
+    if (mode == ReverbMode::Stereo) {
+        wetBlock.copyFrom(bandBlock);
+        runEngine(wetBlock);
+        return;
+    }
+
+    auto *mono = wetBlock.getChannelPointer(0);
+
+    if (mode == ReverbMode::MonoSum) {
+        // Average all channels into one, convolve it and spread it back
+        juce::FloatVectorOperations::copy(mono, bandBlock.getChannelPointer(0), numSamples);
+        for (size_t channel = 1; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::add(mono, bandBlock.getChannelPointer(channel), numSamples);
+        juce::FloatVectorOperations::multiply(mono, 1.0f / static_cast<float>(numChannels), numSamples);
+
+        auto monoBlock = wetBlock.getSingleChannelBlock(0);
+        runEngine(monoBlock);
+
+        for (size_t channel = 1; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::copy(wetBlock.getChannelPointer(channel), mono, numSamples);
+        return;
+    }
+
+    // Mid only: the mid channel is convolved, the side channel bypasses the reverb
+    auto *side = wetBlock.getChannelPointer(1);
+    const auto *left = bandBlock.getChannelPointer(0);
+    const auto *right = bandBlock.getChannelPointer(1);
+
+    juce::FloatVectorOperations::add(mono, left, right, numSamples);
+    juce::FloatVectorOperations::multiply(mono, 0.5f, numSamples);
+    juce::FloatVectorOperations::subtract(side, left, right, numSamples);
+    juce::FloatVectorOperations::multiply(side, 0.5f, numSamples);
+
+    auto midBlock = wetBlock.getSingleChannelBlock(0);
+    runEngine(midBlock);
+
+    // Back to left/right: L = M + S, R = M - S
+    for (int sample = 0; sample < numSamples; ++sample) {
+        const float mid = mono[sample];
+        mono[sample] = mid + side[sample];
+        side[sample] = mid - side[sample];
+    }
+}
+
+void MultibandReverbAudioProcessor::accumulateLevel(size_t meterIndex, const juce::dsp::AudioBlock<float> &block) {
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = static_cast<int>(block.getNumSamples());
+
+    if (numChannels == 0 || numSamples == 0)
+        return;
+
+    // Mean square over all channels, weighted by length so sub-blocks of a host block add up
+    float peak = blockPeaks[meterIndex];
+    float sum = 0.0f;
+
+    for (size_t channel = 0; channel < numChannels; ++channel) {
+        const auto *data = block.getChannelPointer(channel);
+        const auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+        peak = juce::jmax(peak, -range.getStart(), range.getEnd());
+        sum += sumOfSquares(data, numSamples);
+    }
+
+    blockPeaks[meterIndex] = peak;
+    blockMeanSquares[meterIndex] += sum / static_cast<float>(numChannels);
+}
+
+void MultibandReverbAudioProcessor::publishLevels(int numSamples) {
+    if (numSamples <= 0)
+        return;
+
+    const double blockSeconds = numSamples / getSampleRate();
+    const auto rmsCoefficient = static_cast<float>(1.0 - std::exp(-blockSeconds / rmsWindowSeconds));
+    const auto peakFall = static_cast<float>(std::pow(10.0, -peakFallDbPerSecond * blockSeconds / 20.0));
+
+    for (size_t i = 0; i < numMeters; ++i) {
+        const float meanSquare = blockMeanSquares[i] / static_cast<float>(numSamples);
+        smoothedMeanSquares[i] += rmsCoefficient * (meanSquare - smoothedMeanSquares[i]);
+
+        const float heldPeak = meterPeaks[i].load(std::memory_order_relaxed) * peakFall;
+        meterPeaks[i].store(juce::jmax(blockPeaks[i], heldPeak), std::memory_order_relaxed);
+        meterRms[i].store(std::sqrt(smoothedMeanSquares[i]), std::memory_order_relaxed);
+    }
+}
+
+MultibandReverbAudioProcessor::LevelReading MultibandReverbAudioProcessor::getLevel(size_t meterIndex) const { return {meterPeaks[meterIndex].load(std::memory_order_relaxed), meterRms[meterIndex].load(std::memory_order_relaxed)}; }
+
+MultibandReverbAudioProcessor::LevelReading MultibandReverbAudioProcessor::getBandInputLevel(size_t bandIndex) const { return getLevel(bandIndex); }
+
+MultibandReverbAudioProcessor::LevelReading MultibandReverbAudioProcessor::getBandReverbLevel(size_t bandIndex) const { return getLevel(reverbMeterOffset + bandIndex); }
+
+MultibandReverbAudioProcessor::LevelReading MultibandReverbAudioProcessor::getOutputLevel() const { return getLevel(outputMeter); }
+
+void MultibandReverbAudioProcessor::addMeteringClient() { ++meteringClients; }
+
+void MultibandReverbAudioProcessor::removeMeteringClient() {
+    // The last client leaving resets the readings so the next one starts from silence
+    if (--meteringClients == 0) {
+        for (size_t i = 0; i < numMeters; ++i) {
+            meterPeaks[i].store(0.0f, std::memory_order_relaxed);
+            meterRms[i].store(0.0f, std::memory_order_relaxed);
+        }
     }
 }
 
@@ -229,70 +779,179 @@ void MultibandReverbAudioProcessor::setStateInformation(const void *data, int si
     if (xmlState != nullptr) {
         if (xmlState->hasTagName(parameters.state.getType())) {
             parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+            restoreImpulseResponses();
         }
     }
 }
 
-void MultibandReverbAudioProcessor::updateCrossoverFrequencies() {
-    if (lowCrossoverFreq && midCrossoverFreq) {
-        auto lowFreq = lowCrossoverFreq->load();
-        auto midFreq = midCrossoverFreq->load();
-
-        // Update the crossover filters with new frequencies
-        if (!crossovers.empty()) {
-            crossovers[0].lowpass.setCutoffFrequency(lowFreq);
-            crossovers[0].highpass.setCutoffFrequency(lowFreq);
-
-            if (crossovers.size() > 1) {
-                crossovers[1].lowpass.setCutoffFrequency(midFreq);
-                crossovers[1].highpass.setCutoffFrequency(midFreq);
-            }
-        }
+int MultibandReverbAudioProcessor::getInternalBlockSize() const { return parameters.state.getProperty(internalBlockSizeID, defaultInternalBlockSize); }
 
-        DBG("Crossover frequencies updated - Low: " << lowFreq << " Hz, Mid: " << midFreq << " Hz");
+void MultibandReverbAudioProcessor::setInternalBlockSize(int newSize) {
+    // Stored with the session, takes effect on the next prepareToPlay
+    parameters.state.setProperty(internalBlockSizeID, juce::jlimit(minInternalBlockSize, maxInternalBlockSize, newSize), nullptr);
+}
+
+void MultibandReverbAudioProcessor::updateCrossoverFrequencies() {
+    // Audio thread only, the filters glide to new targets so automation and dragging stay smooth
+    if (lowCrossoverFreq && midCrossoverFreq && crossoverSlope) {
+        crossover.setSlope(static_cast<ThreeBandCrossover::Slope>(juce::jlimit(0, 2, juce::roundToInt(crossoverSlope->load()))));
+        crossover.setTargetFrequencies(lowCrossoverFreq->load(), midCrossoverFreq->load());
     }
 }
 
 void MultibandReverbAudioProcessor::loadImpulseResponse(size_t bandIndex, const juce::File &irFile) {
     if (bandIndex < bandReverbs.size()) {
-        auto &reverb = bandReverbs[bandIndex];
+        parameters.state.setProperty(getBandParameterID(bandIndex, "IR"), irFile.getFullPathName(), nullptr);
+        irLoader->load(*this, bandIndex, irFile, ImpulseResponseLoader::Priority::Interactive);
+    }
+}
 
-        juce::AudioFormatManager formatManager;
-        formatManager.registerBasicFormats();
+juce::File MultibandReverbAudioProcessor::getImpulseResponseFile(size_t bandIndex) const {
+    const auto path = parameters.state.getProperty(getBandParameterID(bandIndex, "IR")).toString();
+    return path.isNotEmpty() ? juce::File(path) : juce::File();
+}
 
-        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(irFile));
+void MultibandReverbAudioProcessor::restoreImpulseResponses() {
+    // Queued behind anything the user picks, a session with many instances restores in the
+    // background. Before the first prepareToPlay there are no engines yet, creating them queues the IRs.
+    for (size_t i = 0; i < bandReverbs.size(); ++i) {
+        bool hasEngines = false;
+        {
+            const juce::ScopedLock sl(irLock);
+            hasEngines = !bandReverbs[i].groups.empty();
+        }
 
-        if (reader != nullptr) {
-            DBG("Loading IR file: " << irFile.getFullPathName());
-            DBG("Sample rate: " << reader->sampleRate);
-            DBG("Length in samples: " << reader->lengthInSamples);
+        if (const auto file = getImpulseResponseFile(i); hasEngines && file.existsAsFile())
+            irLoader->load(*this, i, file, ImpulseResponseLoader::Priority::SessionRestore);
+    }
+}
 
-            const auto numSamples = static_cast<int>(reader->lengthInSamples);
+void MultibandReverbAudioProcessor::impulseResponseStarted(size_t bandIndex, [[maybe_unused]] const juce::File &file, juce::int64 length, double sampleRate) {
+    auto &reverb = bandReverbs[bandIndex];
+    const juce::ScopedLock sl(irLock);
 
-            reverb.irBuffer.setSize(1, numSamples);
-            reader->read(&reverb.irBuffer, 0, numSamples, 0, true, false);
+    // Not shareable with other bands until every segment has arrived
+    irHashes[bandIndex] = 0;
+    reverb.pendingIrHash = ImpulseResponseLoader::hashBytes(ImpulseResponseLoader::hashSeed, &sampleRate, sizeof(sampleRate));
+    reverb.irSampleRate = sampleRate;
+    reverb.irGain = 1.0f;
 
-            reverb.convolution = std::make_unique<juce::dsp::Convolution>();
-            reverb.convolution->prepare({getSampleRate(), static_cast<uint32>(getBlockSize()), static_cast<uint32>(getTotalNumOutputChannels())});
+    // The band keeps the start of the IR for fitting the FDN engine
+    reverb.irBuffer.setSize(1, static_cast<int>(juce::jmin(length, maxAnalysisSamples)));
+    reverb.irBuffer.clear();
 
-            reverb.convolution->loadImpulseResponse(std::move(reverb.irBuffer), getSampleRate(), juce::dsp::Convolution::Stereo::no, juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::yes);
+    for (auto &group : reverb.groups)
+        group.convolution->beginImpulseResponse(length);
 
-            DBG("IR loaded successfully into band " << bandIndex);
-        } else {
-            DBG("Failed to read IR file");
-        }
+    DBG("Streaming IR into band " << bandIndex << ": " << file.getFileName());
+}
+
+void MultibandReverbAudioProcessor::impulseResponseSegmentLoaded(size_t bandIndex, size_t slot, juce::AudioBuffer<float> &&segment) {
+    auto &reverb = bandReverbs[bandIndex];
+    const juce::ScopedLock sl(irLock);
+
+    const auto start = StreamingConvolution::getSlotStart(slot);
+    const auto numSamples = segment.getNumSamples();
+    reverb.pendingIrHash = ImpulseResponseLoader::hashBytes(reverb.pendingIrHash, segment.getReadPointer(0), static_cast<size_t>(numSamples) * sizeof(float));
+
+    if (start < reverb.irBuffer.getNumSamples()) {
+        const auto numToKeep = juce::jmin(numSamples, reverb.irBuffer.getNumSamples() - static_cast<int>(start));
+        reverb.irBuffer.copyFrom(0, static_cast<int>(start), segment, 0, 0, numToKeep);
+    }
+
+    // The level is set from the head so later slots never change it
+    if (slot == 0) {
+        const auto *head = segment.getReadPointer(0);
+        double energy = 0.0;
+        for (int i = 0; i < numSamples; ++i)
+            energy += static_cast<double>(head[i]) * head[i];
+
+        reverb.irGain = energy > 0.0 ? static_cast<float>(0.125 / std::sqrt(energy)) : 1.0f;
+    }
+
+    segment.applyGain(reverb.irGain);
+
+    for (size_t i = 0; i < reverb.groups.size(); ++i) {
+        if (i + 1 == reverb.groups.size())
+            reverb.groups[i].convolution->loadSegment(slot, std::move(segment), reverb.irSampleRate);
+        else
+            reverb.groups[i].convolution->loadSegment(slot, juce::AudioBuffer<float>(segment), reverb.irSampleRate);
     }
 }
 
-void MultibandReverbAudioProcessor::parameterChanged(const juce::String &parameterID, [[maybe_unused]] float newValue) {
-    if (parameterID == "lowCross" || parameterID == "midCross") {
-        updateCrossoverFrequencies();
+void MultibandReverbAudioProcessor::impulseResponseFinished(size_t bandIndex) {
+    // Bands with identical IRs share one convolution in processBlock, zero is reserved for "no IR"
+    const juce::ScopedLock sl(irLock);
+    const auto hash = bandReverbs[bandIndex].pendingIrHash;
+    irHashes[bandIndex] = hash == 0 ? 1 : hash;
+
+    DBG("IR loaded successfully into band " << bandIndex);
+}
+
+bool MultibandReverbAudioProcessor::hasReverb(size_t bandIndex, ReverbEngine engine) const { return engine == ReverbEngine::Fdn || (!bandReverbs[bandIndex].groups.empty() && bandReverbs[bandIndex].groups.front().convolution->hasImpulseResponse()); }
+
+float MultibandReverbAudioProcessor::getReverbLevel(size_t leader, ReverbEngine engine) const {
+    if (engine == ReverbEngine::Fdn)
+        return 1.0f;
+
+    return bandReverbs[leader].groups.empty() ? 0.0f : bandReverbs[leader].groups.front().convolution->getLevel();
+}
+
+size_t MultibandReverbAudioProcessor::getConvolutionLeader(size_t bandIndex, const std::array<ReverbMode, 3> &modes, const std::array<ReverbEngine, 3> &engines) const {
+    const auto hash = irHashes[bandIndex].load(std::memory_order_relaxed);
+
+    if (hash != 0 && engines[bandIndex] == ReverbEngine::Convolution) {
+        for (size_t i = 0; i < bandIndex; ++i) {
+            if (i == 0 && !isLowBandShareable)
+                continue;
 
-        // Update analyzer if it exists
-        if (analyzer != nullptr && lowCrossoverFreq != nullptr && midCrossoverFreq != nullptr) {
-            analyzer->setCrossoverFrequencies(lowCrossoverFreq->load(), midCrossoverFreq->load());
+            if (engines[i] == ReverbEngine::Convolution && !bandReverbs[i].groups.empty() && modes[i] == modes[bandIndex] && irHashes[i].load(std::memory_order_relaxed) == hash)
+                return i;
         }
     }
+
+    return bandIndex;
+}
+
+bool MultibandReverbAudioProcessor::fitFdnToImpulseResponse(size_t bandIndex) {
+    if (bandIndex >= bandReverbs.size())
+        return false;
+
+    // The band's frequency range as the crossovers currently split it
+    const float lowEdge = bandIndex == 0 ? 20.0f : (bandIndex == 1 ? lowCrossoverFreq->load() : midCrossoverFreq->load());
+    const float highEdge = bandIndex == 0 ? lowCrossoverFreq->load() : (bandIndex == 1 ? midCrossoverFreq->load() : 20000.0f);
+
+    const auto &reverb = bandReverbs[bandIndex];
+    const FdnReverb::Parameters current{fdnDecays[bandIndex]->load(), fdnSizes[bandIndex]->load(), fdnDensities[bandIndex]->load(), fdnDampings[bandIndex]->load()};
+    juce::AudioBuffer<float> ir;
+    double irSampleRate = 0.0;
+
+    // Fitting filters the whole IR, copy it so the loader thread isn't held up meanwhile
+    {
+        const juce::ScopedLock sl(irLock);
+        if (reverb.irBuffer.getNumSamples() == 0)
+            return false;
+
+        ir.makeCopyOf(reverb.irBuffer);
+        irSampleRate = reverb.irSampleRate;
+    }
+
+    const auto fitted = FdnReverb::fitToImpulseResponse(ir, irSampleRate, lowEdge, highEdge, current);
+
+    auto setParameter = [this, bandIndex](const juce::String &suffix, float value) {
+        if (auto *param = parameters.getParameter(getBandParameterID(bandIndex, suffix)))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    };
+
+    setParameter("Decay", fitted.decaySeconds);
+    setParameter("Damping", fitted.damping);
+    return true;
+}
+
+juce::String MultibandReverbAudioProcessor::getBandParameterID(size_t bandIndex, const juce::String &suffix) {
+    static const char *const prefixes[] = {"low", "mid", "high"};
+    jassert(bandIndex < std::size(prefixes));
+    return prefixes[bandIndex] + suffix;
 }
 
 void MultibandReverbAudioProcessor::updateSoloMuteStates() {
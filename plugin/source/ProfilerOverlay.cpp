@@ -0,0 +1,105 @@
+#include "MultibandReverb/ProfilerOverlay.h"
+
+//==============================================================================
+ProfilerOverlay::ProfilerOverlay(DspProfiler &profilerToUse) : profiler(profilerToUse) {
+    addAndMakeVisible(exportButton);
+    addAndMakeVisible(clearButton);
+
+    exportButton.onClick = [this] { exportButtonClicked(); };
+    clearButton.onClick = [this] {
+        recentFrames.clear();
+        history.clear();
+        stats = {};
+        repaint();
+    };
+
+    recentFrames.reserve(statsWindow * 2);
+}
+
+ProfilerOverlay::~ProfilerOverlay() { stopTimer(); }
+
+void ProfilerOverlay::visibilityChanged() {
+    // Only drain while shown, the FIFO drops frames on its own when nobody reads it
+    if (isVisible())
+        startTimerHz(10);
+    else
+        stopTimer();
+}
+
+void ProfilerOverlay::timerCallback() {
+    const auto firstNew = recentFrames.size();
+
+    if (profiler.readFrames(recentFrames) == 0)
+        return;
+
+    for (size_t i = firstNew; i < recentFrames.size() && history.size() < maxHistory; ++i)
+        history.push_back(recentFrames[i]);
+
+    if (recentFrames.size() > statsWindow)
+        recentFrames.erase(recentFrames.begin(), recentFrames.end() - static_cast<std::ptrdiff_t>(statsWindow));
+
+    stats = DspProfiler::computeStats(recentFrames);
+    repaint();
+}
+
+void ProfilerOverlay::exportButtonClicked() {
+    chooser = std::make_unique<juce::FileChooser>("Export DSP timings...", juce::File::getSpecialLocation(juce::File::userDocumentsDirectory).getChildFile("MultibandReverbTimings.csv"), "*.csv");
+    auto chooserFlags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles | juce::FileBrowserComponent::warnAboutOverwriting;
+
+    chooser->launchAsync(chooserFlags, [this](const juce::FileChooser &fc) {
+        auto file = fc.getResult();
+        if (file == juce::File{})
+            return;
+
+        file.deleteFile();
+        juce::FileOutputStream out(file);
+
+        if (!out.openedOk() || !DspProfiler::writeCsv(history, out)) {
+            juce::NativeMessageBox::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Export Failed", "Could not write " + file.getFullPathName());
+        }
+    });
+}
+
+void ProfilerOverlay::paint(juce::Graphics &g) {
+    g.fillAll(juce::Colours::black.withAlpha(0.85f));
+
+    auto area = getLocalBounds().reduced(10);
+    area.removeFromTop(25); // Buttons
+
+    const int rowHeight = 16;
+    const int nameWidth = 90;
+    const int columnWidth = (area.getWidth() - nameWidth) / 5;
+
+    auto drawRow = [&](const juce::String &name, std::initializer_list<juce::String> columns, juce::Colour colour) {
+        auto row = area.removeFromTop(rowHeight);
+        g.setColour(colour);
+        g.drawText(name, row.removeFromLeft(nameWidth), juce::Justification::centredLeft);
+
+        for (const auto &column : columns)
+            g.drawText(column, row.removeFromLeft(columnWidth), juce::Justification::centredRight);
+    };
+
+    g.setFont(12.0f);
+    drawRow("Stage", {"min us", "avg us", "p99 us", "max us", "% deadline"}, juce::Colours::lightgrey);
+
+    for (int stage = 0; stage < DspProfiler::NumStages; ++stage) {
+        const auto &s = stats[static_cast<size_t>(stage)];
+        const auto colour = s.maxDeadlinePercent > 50.0 ? juce::Colours::orange : juce::Colours::white;
+
+        drawRow(DspProfiler::getStageName(static_cast<DspProfiler::Stage>(stage)),
+                {juce::String(s.minMicros, 1), juce::String(s.avgMicros, 1), juce::String(s.p99Micros, 1), juce::String(s.maxMicros, 1),
+                 juce::String(s.avgDeadlinePercent, 1) + " / " + juce::String(s.maxDeadlinePercent, 1)},
+                colour);
+    }
+
+    g.setColour(juce::Colours::grey);
+    g.drawText(juce::String(recentFrames.size()) + " blocks, " + juce::String(history.size()) + " recorded, " + juce::String(profiler.getNumDroppedFrames()) + " dropped", area.removeFromTop(rowHeight),
+               juce::Justification::centredLeft);
+}
+
+void ProfilerOverlay::resized() {
+    auto buttonArea = getLocalBounds().reduced(10).removeFromTop(20);
+    exportButton.setBounds(buttonArea.removeFromRight(90));
+    buttonArea.removeFromRight(5);
+    clearButton.setBounds(buttonArea.removeFromRight(60));
+}
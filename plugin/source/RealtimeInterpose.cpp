@@ -0,0 +1,163 @@
+// RealtimeInterpose.cpp
+// Allocation, lock and file hooks for RealtimeSafety. Not part of the plugin's shared code: CMake
+// only compiles it into executables, a host's allocator must never be replaced by a plugin it
+// loads. Free of JUCE and libc I/O headers, whose fortified inline wrappers would clash with the
+// libc definitions.
+#include "MultibandReverb/RealtimeSafety.h"
+
+#if MBR_REALTIME_INTERPOSE_LIBC
+#include <atomic>
+#include <cerrno>
+#include <cstdarg>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+struct _IO_FILE;
+}
+
+namespace {
+using MutexLockFn = int (*)(pthread_mutex_t *);
+using OpenFn = int (*)(const char *, int, ...);
+using ReadFn = ssize_t (*)(int, void *, size_t);
+using FopenFn = _IO_FILE *(*)(const char *, const char *);
+
+std::atomic<MutexLockFn> realMutexLock{nullptr};
+std::atomic<OpenFn> realOpen{nullptr};
+std::atomic<ReadFn> realRead{nullptr};
+std::atomic<FopenFn> realFopen{nullptr};
+
+// Looked up on first use, static initialisers in libstdc++ and elsewhere can call a hook before
+// any constructor of ours has run. Resolving twice from racing threads is harmless. Null when
+// the next library doesn't define the function, the hooks then fail the call.
+template <typename Fn> Fn getReal(std::atomic<Fn> &cache, const char *name) {
+    auto fn = cache.load(std::memory_order_acquire);
+
+    if (fn == nullptr) {
+        fn = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+        cache.store(fn, std::memory_order_release);
+    }
+
+    return fn;
+}
+
+// O_CREAT and O_TMPFILE from the Linux ABI, the only flags that pass a mode argument
+constexpr int createFlag = 0100;
+constexpr int tmpFileFlag = 020200000;
+} // namespace
+
+extern "C" {
+void *malloc(size_t size) {
+    RealtimeSafety::checkAllocation("malloc");
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+    RealtimeSafety::checkAllocation("calloc");
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    RealtimeSafety::checkAllocation("realloc");
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    if (ptr != nullptr)
+        RealtimeSafety::checkAllocation("free");
+
+    __libc_free(ptr);
+}
+
+int pthread_mutex_lock(pthread_mutex_t *mutex) {
+    RealtimeSafety::checkLock("pthread_mutex_lock");
+
+    const auto real = getReal(realMutexLock, "pthread_mutex_lock");
+    return real != nullptr ? real(mutex) : EINVAL;
+}
+
+int open(const char *path, int flags, ...) {
+    RealtimeSafety::checkFileAccess("open");
+
+    unsigned int mode = 0;
+
+    if ((flags & createFlag) != 0 || (flags & tmpFileFlag) == tmpFileFlag) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, unsigned int);
+        va_end(args);
+    }
+
+    const auto real = getReal(realOpen, "open");
+    if (real == nullptr) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    return real(path, flags, mode);
+}
+
+ssize_t read(int fd, void *buffer, size_t count) {
+    RealtimeSafety::checkFileAccess("read");
+
+    const auto real = getReal(realRead, "read");
+    if (real == nullptr) {
+        errno = ENOSYS;
+        return -1;
+    }
+
+    return real(fd, buffer, count);
+}
+
+_IO_FILE *fopen(const char *path, const char *mode) {
+    RealtimeSafety::checkFileAccess("fopen");
+
+    const auto real = getReal(realFopen, "fopen");
+    if (real == nullptr) {
+        errno = ENOSYS;
+        return nullptr;
+    }
+
+    return real(path, mode);
+}
+}
+#elif MBR_REALTIME_CHECKS
+#include <cstdlib>
+#include <new>
+
+// Without libc interposition the global allocation functions are the only hook we have
+void *operator new(std::size_t size) {
+    RealtimeSafety::checkAllocation("operator new");
+
+    if (auto *ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    RealtimeSafety::checkAllocation("operator new");
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept { return ::operator new(size, tag); }
+
+void operator delete(void *ptr) noexcept {
+    if (ptr != nullptr)
+        RealtimeSafety::checkAllocation("operator delete");
+
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept { ::operator delete(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { ::operator delete(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { ::operator delete(ptr); }
+#endif
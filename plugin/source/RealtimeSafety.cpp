@@ -0,0 +1,52 @@
+#include "MultibandReverb/RealtimeSafety.h"
+
+#if MBR_REALTIME_CHECKS
+#include <JuceHeader.h>
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+thread_local int realtimeDepth = 0;
+thread_local bool isReporting = false;
+
+bool isTrapping() { return realtimeDepth > 0 && !isReporting; }
+
+[[noreturn]] void reportViolation(const char *kind, const char *function) {
+    // Everything below allocates, so stop trapping before building the report
+    isReporting = true;
+
+    std::fprintf(stderr, "\nRealtime violation in processBlock: %s in %s\n%s\n", kind, function, juce::SystemStats::getStackBacktrace().toRawUTF8());
+    std::fflush(stderr);
+    std::abort();
+}
+} // namespace
+
+//==============================================================================
+void RealtimeSafety::checkAllocation(const char *function) {
+    if (isTrapping())
+        reportViolation("heap allocation", function);
+}
+
+void RealtimeSafety::checkLock(const char *function) {
+    if (isTrapping())
+        reportViolation("mutex lock", function);
+}
+
+void RealtimeSafety::checkFileAccess(const char *function) {
+    if (isTrapping())
+        reportViolation("file access", function);
+}
+
+RealtimeSafety::ScopedRealtimeSection::ScopedRealtimeSection() { ++realtimeDepth; }
+RealtimeSafety::ScopedRealtimeSection::~ScopedRealtimeSection() { --realtimeDepth; }
+
+#else
+
+void RealtimeSafety::checkAllocation(const char *) {}
+void RealtimeSafety::checkLock(const char *) {}
+void RealtimeSafety::checkFileAccess(const char *) {}
+
+RealtimeSafety::ScopedRealtimeSection::ScopedRealtimeSection() {}
+RealtimeSafety::ScopedRealtimeSection::~ScopedRealtimeSection() {}
+
+#endif
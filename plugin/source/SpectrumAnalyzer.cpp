@@ -1,11 +1,33 @@
 #include "MultibandReverb/SpectrumAnalyzer.h"
 #include "MultibandReverb/PluginProcessor.h"
 
+namespace {
+constexpr float spectrogramMinDb = -100.0f;
+
+// Spectrogram colours from silence to full scale, looked up instead of interpolated per pixel.
+// Built on first use rather than at static init, which may run before juce::Colours exists.
+const std::array<juce::PixelARGB, 256> &getSpectrogramColours() {
+    static const auto table = [] {
+        juce::ColourGradient gradient(juce::Colours::black, 0.0f, 0.0f, juce::Colours::white, 1.0f, 0.0f, false);
+        gradient.addColour(0.3, juce::Colours::darkblue);
+        gradient.addColour(0.55, juce::Colours::purple);
+        gradient.addColour(0.75, juce::Colours::orange);
+        gradient.addColour(0.9, juce::Colours::yellow);
+
+        std::array<juce::PixelARGB, 256> result;
+        for (size_t i = 0; i < result.size(); ++i)
+            result[i] = gradient.getColourAtPosition(static_cast<double>(i) / (result.size() - 1)).getPixelARGB();
+        return result;
+    }();
+
+    return table;
+}
+} // namespace
+
 //==============================================================================
-SpectrumAnalyzer::SpectrumAnalyzer()
-    : fft(11), // 2048 points
-      window(2048, juce::dsp::WindowingFunction<float>::hann) {
-    startTimerHz(60); // 60 fps refresh rate
+SpectrumAnalyzer::SpectrumAnalyzer(int order)
+    : fftOrder(order), fftSize(1 << order), fftData(static_cast<size_t>(fftSize) * 2), fifo(static_cast<size_t>(fftSize)), smoothedFFTData(static_cast<size_t>(fftSize) / 2 + 1) {
+    startTimerHz(refreshHz);
     setOpaque(true);
 }
 
@@ -80,37 +102,41 @@ void SpectrumAnalyzer::paint(juce::Graphics &g) {
     auto width = bounds.getWidth();
     auto height = bounds.getHeight();
 
-    // Create path for spectrum
-    juce::Path spectrumPath;
-
     auto minFreq = 20.0f;
     auto maxFreq = 20000.0f;
     const float minDb = -100.0f;
     const float maxDb = 12.0f; // Extend range to +12dB
 
-    // Start the path at the bottom-left
-    spectrumPath.startNewSubPath(0, (float)height);
+    if (view == View::Spectrogram) {
+        drawSpectrogram(g);
+    } else {
+        // Create path for spectrum
+        juce::Path spectrumPath;
 
-    // Create points for the curve
-    for (int x = 0; x < width; x += 2) {
-        auto freq = std::exp(std::log(minFreq) + (std::log(maxFreq) - std::log(minFreq)) * x / width);
-        auto level = getSmoothedValueForFrequency(freq, minFreq, maxFreq, width);
-        auto dbLevel = juce::Decibels::gainToDecibels(level, minDb);
-        auto normalizedLevel = juce::jmap(dbLevel, minDb, maxDb, 0.0f, 0.7f);
+        // Start the path at the bottom-left
+        spectrumPath.startNewSubPath(0, (float)height);
 
-        spectrumPath.lineTo(x, height * (1.0f - normalizedLevel));
-    }
+        // Create points for the curve
+        for (int x = 0; x < width; x += 2) {
+            auto freq = std::exp(std::log(minFreq) + (std::log(maxFreq) - std::log(minFreq)) * x / width);
+            auto level = getSmoothedValueForFrequency(freq, minFreq, maxFreq, width);
+            auto dbLevel = juce::Decibels::gainToDecibels(level, minDb);
+            auto normalizedLevel = juce::jmap(dbLevel, minDb, maxDb, 0.0f, 0.7f);
+
+            spectrumPath.lineTo(x, height * (1.0f - normalizedLevel));
+        }
 
-    // Complete the path
-    spectrumPath.lineTo(width, (float)height);
-    spectrumPath.closeSubPath();
+        // Complete the path
+        spectrumPath.lineTo(width, (float)height);
+        spectrumPath.closeSubPath();
 
-    // Draw spectrum with gradient fill
-    g.setGradientFill(juce::ColourGradient(juce::Colours::lightblue.withAlpha(0.8f), 0, 0, juce::Colours::lightblue.withAlpha(0.2f), 0, (float)height, false));
+        // Draw spectrum with gradient fill
+        g.setGradientFill(juce::ColourGradient(juce::Colours::lightblue.withAlpha(0.8f), 0, 0, juce::Colours::lightblue.withAlpha(0.2f), 0, (float)height, false));
 
-    // Smooth the path
-    auto smoothedPath = spectrumPath.createPathWithRoundedCorners(5.0f);
-    g.fillPath(smoothedPath);
+        // Smooth the path
+        auto smoothedPath = spectrumPath.createPathWithRoundedCorners(5.0f);
+        g.fillPath(smoothedPath);
+    }
 
     // Draw grid lines
     g.setColour(juce::Colours::white.withAlpha(0.2f));
@@ -125,15 +151,22 @@ void SpectrumAnalyzer::paint(juce::Graphics &g) {
         g.drawText(juce::String(freq) + "Hz", (int)x - 20, height - 20, 40, 20, juce::Justification::centred);
     }
 
-    // Level grid lines
-    const int levels[] = {12, 0, -12, -24, -36, -48, -60};
-    for (int level : levels) {
-        float normalizedY = juce::jmap((float)level, minDb, maxDb, 1.0f, 0.0f);
-        float y = height * normalizedY;
-        g.drawHorizontalLine((int)y, 0.0f, (float)width);
+    // Level grid lines, the spectrogram shows level as colour instead
+    if (view == View::Spectrum) {
+        const int levels[] = {12, 0, -12, -24, -36, -48, -60};
+        for (int level : levels) {
+            float normalizedY = juce::jmap((float)level, minDb, maxDb, 1.0f, 0.0f);
+            float y = height * normalizedY;
+            g.drawHorizontalLine((int)y, 0.0f, (float)width);
+
+            g.setColour(juce::Colours::white.withAlpha(0.2f));
+            g.drawText(juce::String(level) + "dB", width - 35, (int)y - 10, 30, 20, juce::Justification::right);
+        }
+    }
 
-        g.setColour(juce::Colours::white.withAlpha(0.2f));
-        g.drawText(juce::String(level) + "dB", width - 35, (int)y - 10, 30, 20, juce::Justification::right);
+    if (isPaused) {
+        g.setColour(juce::Colours::white.withAlpha(0.6f));
+        g.drawText("Analyzer paused by the CPU governor", getLocalBounds().removeFromTop(30), juce::Justification::centred);
     }
 
     // Update crossover line drawing
@@ -164,15 +197,53 @@ void SpectrumAnalyzer::paint(juce::Graphics &g) {
 }
 
 void SpectrumAnalyzer::timerCallback() {
+    // Follow the crossover parameters on the message thread, whichever thread changed them
+    if (audioProcessor != nullptr && currentDrag == None) {
+        const float low = audioProcessor->parameters.getRawParameterValue("lowCross")->load();
+        const float mid = audioProcessor->parameters.getRawParameterValue("midCross")->load();
+
+        if (low != lowCrossoverFreq || mid != midCrossoverFreq)
+            setCrossoverFrequencies(low, mid);
+
+        if (const auto rate = audioProcessor->getSampleRate(); rate > 0.0 && rate != sampleRate) {
+            sampleRate = rate;
+            updateSpectrogramColumns();
+        }
+
+        // Fewer FFT frames while the CPU governor reduces the analyzer, none while it pauses it
+        const auto tier = audioProcessor->governor.getTier();
+        const int targetHz = tier >= CpuGovernor::Tier::ReducedAnalyzer ? reducedRefreshHz : refreshHz;
+
+        if (getTimerInterval() != 1000 / targetHz)
+            startTimerHz(targetHz);
+
+        if (const bool shouldPause = tier >= CpuGovernor::Tier::AnalyzerPaused; shouldPause != isPaused) {
+            isPaused = shouldPause;
+            repaint();
+        }
+
+        if (isPaused)
+            return;
+    }
+
     if (nextFFTBlockReady) {
-        window.multiplyWithWindowingTable(fftData.data(), 2048);
-        fft.performFrequencyOnlyForwardTransform(fftData.data());
+        if (fft == nullptr) {
+            fft = std::make_unique<juce::dsp::FFT>(fftOrder);
+            window = std::make_unique<juce::dsp::WindowingFunction<float>>(static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann);
+        }
+
+        window->multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+        fft->performFrequencyOnlyForwardTransform(fftData.data());
 
         // Apply temporal smoothing
-        for (size_t i = 0; i < fftData.size(); ++i) {
+        for (size_t i = 0; i < smoothedFFTData.size(); ++i) {
             smoothedFFTData[i] = smoothedFFTData[i] * temporalSmoothing + fftData[i] * (1.0f - temporalSmoothing);
         }
 
+        // The spectrogram takes the unsmoothed frame, so decays aren't blurred
+        if (view == View::Spectrogram)
+            writeSpectrogramRow();
+
         nextFFTBlockReady = false;
         repaint();
     }
@@ -180,14 +251,14 @@ void SpectrumAnalyzer::timerCallback() {
 
 float SpectrumAnalyzer::getSmoothedValueForFrequency(float freq, float minFreq, float maxFreq, int width) {
     auto getNormalizedBinValue = [this](int bin) {
-        if (bin >= 0 && bin < 2048)
-            return smoothedFFTData[bin];
+        if (bin >= 0 && bin < static_cast<int>(smoothedFFTData.size()))
+            return smoothedFFTData[static_cast<size_t>(bin)];
         return 0.0f;
     };
 
     // Calculate which FFT bin corresponds to this frequency
-    float binFreq = freq * 2048.0f / 44100.0f;
-    int centralBin = juce::jlimit(0, 1024, (int)binFreq);
+    float binFreq = freq * static_cast<float>(fftSize / sampleRate);
+    int centralBin = juce::jlimit(0, fftSize / 2, (int)binFreq);
 
     // Average over nearby bins for spectral smoothing
     float sum = 0.0f;
@@ -207,7 +278,7 @@ void SpectrumAnalyzer::pushBuffer(const float *data, int size) {
             fifo[static_cast<size_t>(fifoIndex)] = data[i];
             ++fifoIndex;
 
-            if (fifoIndex >= 2048) {
+            if (fifoIndex >= fftSize) {
                 std::copy(fifo.begin(), fifo.end(), fftData.begin());
                 nextFFTBlockReady = true;
                 fifoIndex = 0;
@@ -216,7 +287,87 @@ void SpectrumAnalyzer::pushBuffer(const float *data, int size) {
     }
 }
 
-void SpectrumAnalyzer::resized() {}
+void SpectrumAnalyzer::resized() {
+    // The history is one row per frame at the current size, so a new size starts it again
+    if (getWidth() > 0 && getHeight() > 0)
+        spectrogram = juce::Image(juce::Image::ARGB, getWidth(), getHeight(), true, juce::SoftwareImageType());
+    else
+        spectrogram = {};
+
+    spectrogramRow = 0;
+    updateSpectrogramColumns();
+}
+
+void SpectrumAnalyzer::setView(View newView) {
+    if (newView == view)
+        return;
+
+    view = newView;
+
+    if (view == View::Spectrogram && spectrogram.isValid()) {
+        spectrogram.clear(spectrogram.getBounds());
+        spectrogramRow = 0;
+    }
+
+    repaint();
+}
+
+void SpectrumAnalyzer::updateSpectrogramColumns() {
+    const int width = getWidth();
+    columnBins.resize(static_cast<size_t>(juce::jmax(0, width + 1)));
+
+    // Each pixel column covers the bins between its frequency and the next column's, at least one
+    const int numBins = fftSize / 2 + 1;
+    for (int x = 0; x <= width; ++x) {
+        const auto bin = static_cast<int>(getFrequencyForX(static_cast<float>(x)) * fftSize / sampleRate);
+        columnBins[static_cast<size_t>(x)] = juce::jlimit(0, numBins - 1, bin);
+    }
+}
+
+void SpectrumAnalyzer::writeSpectrogramRow() {
+    if (!spectrogram.isValid() || columnBins.size() != static_cast<size_t>(spectrogram.getWidth()) + 1)
+        return;
+
+    // Rows are written upwards round the ring, so reading down from the newest goes back in time
+    const int height = spectrogram.getHeight();
+    spectrogramRow = (spectrogramRow + height - 1) % height;
+
+    const juce::Image::BitmapData pixels(spectrogram, 0, spectrogramRow, spectrogram.getWidth(), 1, juce::Image::BitmapData::writeOnly);
+    jassert(pixels.pixelFormat == juce::Image::ARGB);
+
+    // The window is normalised, so a full scale sine peaks at half the FFT size
+    const float magnitudeToGain = 2.0f / static_cast<float>(fftSize);
+    const auto &colours = getSpectrogramColours();
+    const auto lastIndex = static_cast<float>(colours.size() - 1);
+
+    for (int x = 0; x < spectrogram.getWidth(); ++x) {
+        const auto first = columnBins[static_cast<size_t>(x)];
+        const auto last = juce::jmax(first, columnBins[static_cast<size_t>(x) + 1] - 1);
+
+        float peak = 0.0f;
+        for (int bin = first; bin <= last; ++bin)
+            peak = juce::jmax(peak, fftData[static_cast<size_t>(bin)]);
+
+        const float db = juce::Decibels::gainToDecibels(peak * magnitudeToGain, spectrogramMinDb);
+        const auto index = static_cast<size_t>(juce::jlimit(0.0f, lastIndex, juce::jmap(db, spectrogramMinDb, 0.0f, 0.0f, lastIndex)));
+        *reinterpret_cast<juce::PixelARGB *>(pixels.getPixelPointer(x, 0)) = colours[index];
+    }
+}
+
+void SpectrumAnalyzer::drawSpectrogram(juce::Graphics &g) {
+    if (!spectrogram.isValid())
+        return;
+
+    // Two blits from the ring: the newest row to the end of the image, then the wrapped rows
+    const int width = spectrogram.getWidth();
+    const int height = spectrogram.getHeight();
+    const int newestRows = height - spectrogramRow;
+
+    g.drawImage(spectrogram, 0, 0, width, newestRows, 0, spectrogramRow, width, newestRows);
+
+    if (spectrogramRow > 0)
+        g.drawImage(spectrogram, 0, newestRows, width, spectrogramRow, 0, 0, width, spectrogramRow);
+}
 
 void SpectrumAnalyzer::setCrossoverFrequencies(float lowCross, float midCross) {
     lowCrossoverFreq = lowCross;
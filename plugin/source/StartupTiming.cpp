@@ -0,0 +1,42 @@
+#include "MultibandReverb/StartupTiming.h"
+
+namespace {
+std::atomic<int> instanceCount{0};
+} // namespace
+
+//==============================================================================
+StartupTiming::StartupTiming() : creationTicks(juce::Time::getHighResolutionTicks()), instance(++instanceCount) {
+    // Only runs until the first processBlock has been logged
+    startTimerHz(10);
+}
+
+StartupTiming::~StartupTiming() { stopTimer(); }
+
+void StartupTiming::record(Stage stage, juce::int64 ticks) const {
+    const auto ms = 1000.0 * static_cast<double>(ticks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    juce::Logger::writeToLog("Startup timing, instance " + juce::String(instance) + ": " + getStageName(stage) + " " + juce::String(ms, 2) + " ms");
+}
+
+void StartupTiming::timerCallback() {
+    if (const auto ticks = firstBlockTicks.load(std::memory_order_acquire); ticks >= 0) {
+        record(FirstProcessBlock, ticks);
+        stopTimer();
+    }
+}
+
+const char *StartupTiming::getStageName(Stage stage) {
+    switch (stage) {
+    case ProcessorConstruction:
+        return "processor construction";
+    case PrepareToPlay:
+        return "prepareToPlay";
+    case FirstProcessBlock:
+        return "first processBlock";
+    case EditorConstruction:
+        return "editor construction";
+    case FirstPaint:
+        return "editor open to first paint";
+    }
+
+    return "";
+}
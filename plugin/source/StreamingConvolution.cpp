@@ -0,0 +1,311 @@
+#include "MultibandReverb/StreamingConvolution.h"
+
+namespace {
+// JUCE crossfades each engine change over 50 ms, a slot waits that out before it is heard
+constexpr double settleSeconds = 0.06;
+constexpr double fadeSeconds = 0.02;
+constexpr int minSegmentLength = 64;
+constexpr int slotHeadSize = 1024; // Uniform head of each slot's non-uniform partitioning
+} // namespace
+
+//==============================================================================
+juce::int64 StreamingConvolution::getSlotLength(size_t slot) { return headLength << juce::jmin(slot, static_cast<size_t>(maxDoublings)); }
+
+juce::int64 StreamingConvolution::getSlotStart(size_t slot) {
+    if (slot <= static_cast<size_t>(maxDoublings))
+        return headLength * ((juce::int64{1} << slot) - 1);
+
+    // Past the doublings every slot has the maximum length
+    return headLength * ((juce::int64{1} << (maxDoublings + 1)) - 1) + static_cast<juce::int64>(slot - maxDoublings - 1) * maxSlotLength;
+}
+
+size_t StreamingConvolution::getNumSlots(juce::int64 irLength) {
+    size_t numSlots = 0;
+    while (getSlotStart(numSlots) < irLength)
+        ++numSlots;
+    return numSlots;
+}
+
+StreamingConvolution::MessageQueue::MessageQueue() = default;
+
+void StreamingConvolution::MessageQueue::reserveLoad() {
+    // Pops are serialised by JUCE, so running the queue here is safe beside its own thread
+    if (loadsSinceRun >= capacity / 2) {
+        runner.prepare({44100.0, 64, 1});
+        loadsSinceRun = 0;
+    }
+
+    ++loadsSinceRun;
+}
+
+StreamingConvolution::StreamingConvolution(MessageQueue &queue) : messageQueue(queue) {}
+
+void StreamingConvolution::prepare(const juce::dsp::ProcessSpec &newSpec) {
+    spec = newSpec;
+    settleLength = static_cast<int>(settleSeconds * spec.sampleRate);
+    fadeStep = 1.0f / static_cast<float>(juce::jmax(1.0, fadeSeconds * spec.sampleRate));
+
+    // The audio thread is stopped, nothing can still be using retired layouts
+    active = nullptr;
+    fading = nullptr;
+    activeLayout.store(nullptr);
+    fadingLayout.store(nullptr);
+    level.store(0.0f, std::memory_order_relaxed);
+    retired.clear();
+
+    if (owned != nullptr)
+        prepareLayout(*owned);
+}
+
+void StreamingConvolution::prepareLayout(Layout &layout) const {
+    if (spec.sampleRate <= 0.0 || spec.numChannels == 0)
+        return;
+
+    for (auto &slot : layout.slots) {
+        slot->convolution->prepare(spec);
+        slot->isAudible = false;
+        slot->isSuspended = false;
+        slot->settleSamples = 0;
+        slot->gain = 0.0f;
+    }
+
+    // The ring reaches back to the start of the last slot and no further, a block is read back
+    // before the next one overwrites it
+    const auto lastStart = layout.slots.size() > 1 ? static_cast<size_t>(getSlotStart(layout.slots.size() - 1)) : 0;
+    layout.historyLength = lastStart + spec.maximumBlockSize;
+    layout.history.assign(spec.numChannels, std::vector<float>(layout.historyLength, 0.0f));
+    layout.writePosition = 0;
+
+    layout.slotBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+    layout.sumBuffer.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize));
+}
+
+void StreamingConvolution::freeRetiredLayouts() {
+    const auto blocks = processedBlocks.load(std::memory_order_acquire);
+    const auto *stillActive = activeLayout.load(std::memory_order_acquire);
+    const auto *stillFading = fadingLayout.load(std::memory_order_acquire);
+
+    std::erase_if(retired, [&](const RetiredLayout &entry) {
+        const auto *layout = entry.layout.get();
+        return blocks >= entry.retiredAtBlock + 2 && layout != stillActive && layout != stillFading;
+    });
+}
+
+void StreamingConvolution::beginImpulseResponse(juce::int64 irLength) {
+    freeRetiredLayouts();
+
+    auto layout = std::make_unique<Layout>();
+    const auto numSlots = getNumSlots(irLength);
+    layout->irLength = irLength;
+
+    for (size_t i = 0; i < numSlots; ++i) {
+        auto slot = std::make_unique<Slot>();
+        slot->convolution = std::make_unique<juce::dsp::Convolution>(juce::dsp::Convolution::NonUniform{slotHeadSize}, messageQueue.getQueue());
+        layout->slots.push_back(std::move(slot));
+    }
+
+    prepareLayout(*layout);
+    current.store(layout.get(), std::memory_order_release);
+
+    if (owned != nullptr)
+        retired.push_back({std::move(owned), processedBlocks.load(std::memory_order_acquire)});
+
+    owned = std::move(layout);
+}
+
+void StreamingConvolution::loadSegment(size_t slot, juce::AudioBuffer<float> &&segment, double sampleRate) {
+    if (owned == nullptr || slot >= owned->slots.size())
+        return;
+
+    // Very short tails are padded so a loaded slot can be told apart from JUCE's initial one sample engine
+    if (segment.getNumSamples() < minSegmentLength)
+        segment.setSize(segment.getNumChannels(), minSegmentLength, true, true);
+
+    auto &target = *owned->slots[slot];
+    owned->irSampleRate.store(sampleRate, std::memory_order_release);
+    messageQueue.reserveLoad();
+    target.convolution->loadImpulseResponse(std::move(segment), sampleRate, juce::dsp::Convolution::Stereo::no, juce::dsp::Convolution::Trim::no, juce::dsp::Convolution::Normalise::no);
+    target.isLoaded.store(true, std::memory_order_release);
+}
+
+void StreamingConvolution::processLayout(Layout &layout, const juce::dsp::AudioBlock<float> &input, size_t numChannels, size_t numSamples) {
+    auto sum = juce::dsp::AudioBlock<float>(layout.sumBuffer).getSubsetChannelBlock(0, numChannels).getSubBlock(0, numSamples);
+    auto scratch = juce::dsp::AudioBlock<float>(layout.slotBuffer).getSubsetChannelBlock(0, numChannels).getSubBlock(0, numSamples);
+    const auto historyLength = layout.historyLength;
+    const auto numInts = static_cast<int>(numSamples);
+
+    sum.clear();
+
+    // Record the input for the delayed slots. Channels left out of this block record silence so
+    // they don't replay stale input once they are processed again.
+    const auto firstPart = juce::jmin(numSamples, historyLength - layout.writePosition);
+
+    for (size_t channel = 0; channel < layout.history.size(); ++channel) {
+        auto *ring = layout.history[channel].data();
+
+        if (channel < numChannels) {
+            juce::FloatVectorOperations::copy(ring + layout.writePosition, input.getChannelPointer(channel), static_cast<int>(firstPart));
+            juce::FloatVectorOperations::copy(ring, input.getChannelPointer(channel) + firstPart, static_cast<int>(numSamples - firstPart));
+        } else {
+            juce::FloatVectorOperations::clear(ring + layout.writePosition, static_cast<int>(firstPart));
+            juce::FloatVectorOperations::clear(ring, static_cast<int>(numSamples - firstPart));
+        }
+    }
+
+    for (size_t i = 0; i < layout.slots.size(); ++i) {
+        auto &slot = *layout.slots[i];
+
+        if (!slot.isLoaded.load(std::memory_order_acquire))
+            continue;
+
+        // Past the tail limit a slot is only processed until it has faded out
+        const bool isWithinTail = i < maxSlots;
+
+        if (!isWithinTail && slot.gain <= 0.0f) {
+            if (!slot.isSuspended) {
+                slot.isSuspended = true;
+                slot.isAudible = false;
+                slot.settleSamples = 0;
+            }
+            continue;
+        }
+
+        // Its engine still holds the input from before it was suspended
+        if (slot.isSuspended) {
+            slot.convolution->reset();
+            slot.isSuspended = false;
+        }
+
+        if (i == 0) {
+            scratch.copyFrom(input);
+        } else {
+            auto readPosition = layout.writePosition + historyLength - static_cast<size_t>(getSlotStart(i));
+            if (readPosition >= historyLength)
+                readPosition -= historyLength;
+
+            const auto firstPart = juce::jmin(numSamples, historyLength - readPosition);
+
+            for (size_t channel = 0; channel < numChannels; ++channel) {
+                const auto *ring = layout.history[channel].data();
+                juce::FloatVectorOperations::copy(scratch.getChannelPointer(channel), ring + readPosition, static_cast<int>(firstPart));
+                juce::FloatVectorOperations::copy(scratch.getChannelPointer(channel) + firstPart, ring, static_cast<int>(numSamples - firstPart));
+            }
+        }
+
+        slot.convolution->process(juce::dsp::ProcessContextReplacing<float>(scratch));
+
+        // Hold the slot back until its IR is swapped in and the crossfade from the initial engine is over
+        if (!slot.isAudible) {
+            if (slot.convolution->getCurrentIRSize() > 1)
+                slot.settleSamples += numInts;
+
+            slot.isAudible = slot.settleSamples >= settleLength;
+            if (!slot.isAudible)
+                continue;
+        }
+
+        if (isWithinTail && slot.gain >= 1.0f) {
+            sum.add(scratch);
+            continue;
+        }
+
+        const float step = isWithinTail ? fadeStep : -fadeStep;
+
+        for (size_t channel = 0; channel < numChannels; ++channel) {
+            auto *destination = sum.getChannelPointer(channel);
+            const auto *source = scratch.getChannelPointer(channel);
+            float gain = slot.gain;
+
+            for (int sample = 0; sample < numInts; ++sample) {
+                gain = juce::jlimit(0.0f, 1.0f, gain + step);
+                destination[sample] += source[sample] * gain;
+            }
+        }
+
+        slot.gain = juce::jlimit(0.0f, 1.0f, slot.gain + step * static_cast<float>(numSamples));
+    }
+
+    layout.writePosition += numSamples;
+    if (layout.writePosition >= historyLength)
+        layout.writePosition -= historyLength;
+}
+
+void StreamingConvolution::process(const juce::dsp::ProcessContextReplacing<float> &context) {
+    auto &block = context.getOutputBlock();
+    const auto numSamples = juce::jmin(block.getNumSamples(), static_cast<size_t>(spec.maximumBlockSize));
+    const auto numChannels = juce::jmin(block.getNumChannels(), static_cast<size_t>(spec.numChannels));
+
+    // A new IR fades the previous one out once its own head is audible. One arriving mid-fade
+    // waits for the fade to finish, dropping the outgoing layout early would click, and in the
+    // meantime the fade runs on without waiting for the head of an IR that is already replaced.
+    auto *latest = current.load(std::memory_order_acquire);
+    if (latest != active && fading == nullptr) {
+        fading = active;
+        fadingGain = 1.0f;
+        active = latest;
+    }
+
+    if (active != nullptr)
+        processLayout(*active, block, numChannels, numSamples);
+
+    if (fading != nullptr)
+        processLayout(*fading, block, numChannels, numSamples);
+
+    if (active != nullptr)
+        block.copyFrom(juce::dsp::AudioBlock<float>(active->sumBuffer).getSubsetChannelBlock(0, numChannels).getSubBlock(0, numSamples));
+    else
+        block.clear();
+
+    if (fading != nullptr) {
+        const bool isHeadReady = active == nullptr || active->slots.empty() || active->slots[0]->isAudible || latest != active;
+        const float step = isHeadReady ? fadeStep : 0.0f;
+
+        for (size_t channel = 0; channel < numChannels; ++channel) {
+            auto *destination = block.getChannelPointer(channel);
+            const auto *source = fading->sumBuffer.getReadPointer(static_cast<int>(channel));
+            float gain = fadingGain;
+
+            for (size_t sample = 0; sample < numSamples; ++sample) {
+                gain = juce::jmax(0.0f, gain - step);
+                destination[sample] += source[sample] * gain;
+            }
+        }
+
+        fadingGain = juce::jmax(0.0f, fadingGain - step * static_cast<float>(numSamples));
+        if (fadingGain <= 0.0f)
+            fading = nullptr;
+    }
+
+    // An outgoing IR still counts while it fades, as far as its own head had come in
+    const auto getHeadGain = [](const Layout *layout) { return layout != nullptr && !layout->slots.empty() && layout->slots[0]->isAudible ? layout->slots[0]->gain : 0.0f; };
+    level.store(juce::jmin(1.0f, getHeadGain(active) + getHeadGain(fading) * fadingGain), std::memory_order_relaxed);
+
+    activeLayout.store(active, std::memory_order_release);
+    fadingLayout.store(fading, std::memory_order_release);
+    processedBlocks.fetch_add(1, std::memory_order_release);
+}
+
+juce::int64 StreamingConvolution::getTailSamples() const {
+    juce::int64 tail = 0;
+
+    for (const auto *layout : {active, fading}) {
+        if (layout == nullptr)
+            continue;
+
+        if (const auto rate = layout->irSampleRate.load(std::memory_order_acquire); rate > 0.0)
+            tail = juce::jmax(tail, static_cast<juce::int64>(std::ceil(static_cast<double>(layout->irLength) * spec.sampleRate / rate)));
+    }
+
+    return tail;
+}
+
+void StreamingConvolution::reset() {
+    for (auto *layout : {active, fading}) {
+        if (layout == nullptr)
+            continue;
+
+        for (auto &slot : layout->slots)
+            if (slot->isLoaded.load(std::memory_order_acquire))
+                slot->convolution->reset();
+    }
+}
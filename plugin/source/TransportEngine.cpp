@@ -0,0 +1,187 @@
+#include "MultibandReverb/TransportEngine.h"
+
+//==============================================================================
+TransportEngine::TransportEngine() = default;
+
+TransportEngine::~TransportEngine() {
+    readAheadThread.removeTimeSliceClient(this);
+    readAheadThread.stopThread(1000);
+}
+
+bool TransportEngine::loadFile(const juce::File &file) {
+    if (formatManager.getNumKnownFormats() == 0)
+        formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+
+    if (reader == nullptr || reader->sampleRate <= 0.0)
+        return false;
+
+    const auto fileSampleRate = reader->sampleRate;
+    const auto length = static_cast<double>(reader->lengthInSamples) / fileSampleRate;
+    auto newSource = std::make_unique<juce::AudioFormatReaderSource>(reader.release(), true);
+    auto newResampler = std::make_unique<juce::ResamplingAudioSource>(newSource.get(), false, numFifoChannels);
+
+    {
+        // The old resampler goes before the source it reads from
+        const juce::ScopedLock sl(sourceLock);
+        resampler = std::move(newResampler);
+        readerSource = std::move(newSource);
+        sourceSampleRate = fileSampleRate;
+        resampledRate = 0.0;
+        isSourceExhausted = false;
+        seekTarget = 0.0;
+    }
+
+    // The FIFO is allocated before the audio thread can see a file
+    if (!readAheadThread.isThreadRunning()) {
+        fifoBuffer.setSize(numFifoChannels, readAheadSamples);
+        readAheadThread.addTimeSliceClient(this);
+        readAheadThread.startThread();
+    }
+
+    currentFile = file;
+    lengthInSeconds = length;
+    hasSource.store(true, std::memory_order_release);
+    readAheadThread.moveToFrontOfQueue(this);
+    return true;
+}
+
+void TransportEngine::start() {
+    if (hasFile() && !playing.exchange(true))
+        sendChangeMessage();
+}
+
+void TransportEngine::stop() {
+    if (playing.exchange(false))
+        sendChangeMessage();
+}
+
+void TransportEngine::setPosition(double seconds) {
+    if (!hasFile())
+        return;
+
+    seekTarget = juce::jlimit(0.0, getLengthInSeconds(), seconds);
+    readAheadThread.moveToFrontOfQueue(this);
+}
+
+double TransportEngine::getCurrentPosition() const {
+    const auto rate = deviceSampleRate.load(std::memory_order_relaxed);
+    const auto played = rate > 0.0 ? static_cast<double>(samplesPlayed.load(std::memory_order_relaxed)) / rate : 0.0;
+    return juce::jmin(fifoStartSeconds.load(std::memory_order_relaxed) + played, getLengthInSeconds());
+}
+
+void TransportEngine::prepareToPlay([[maybe_unused]] int samplesPerBlockExpected, double sampleRate) {
+    // The read-ahead thread notices a new rate and refills from the current position
+    deviceSampleRate = sampleRate;
+}
+
+void TransportEngine::getNextAudioBlock(const juce::AudioSourceChannelInfo &bufferToFill) {
+    if (!hasFile()) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    // Only the reader may empty the FIFO, the read-ahead thread waits for this before a seek
+    if (flushState.load(std::memory_order_acquire) == FlushRequested) {
+        fifo.finishedRead(fifo.getNumReady());
+        samplesPlayed.store(0, std::memory_order_relaxed);
+        flushState.store(FlushDone, std::memory_order_release);
+    }
+
+    if (!isPlaying()) {
+        bufferToFill.clearActiveBufferRegion();
+        return;
+    }
+
+    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+    fifo.prepareToRead(bufferToFill.numSamples, start1, size1, start2, size2);
+
+    const auto numRead = size1 + size2;
+    const auto startSample = bufferToFill.startSample;
+    auto &buffer = *bufferToFill.buffer;
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+        if (channel >= numFifoChannels) {
+            buffer.clear(channel, startSample, bufferToFill.numSamples);
+            continue;
+        }
+
+        if (size1 > 0)
+            buffer.copyFrom(channel, startSample, fifoBuffer, channel, start1, size1);
+        if (size2 > 0)
+            buffer.copyFrom(channel, startSample + size1, fifoBuffer, channel, start2, size2);
+
+        // An underrun plays silence rather than waiting for the disk
+        if (numRead < bufferToFill.numSamples)
+            buffer.clear(channel, startSample + numRead, bufferToFill.numSamples - numRead);
+    }
+
+    fifo.finishedRead(numRead);
+    samplesPlayed.fetch_add(numRead, std::memory_order_relaxed);
+}
+
+void TransportEngine::releaseResources() {
+    // The FIFO and the read-ahead thread stay, the next prepareToPlay carries on from them
+}
+
+int TransportEngine::useTimeSlice() {
+    const juce::ScopedLock sl(sourceLock);
+    const auto rate = deviceSampleRate.load();
+
+    if (resampler == nullptr || rate <= 0.0)
+        return 50;
+
+    // A new device rate carries on from where playback is
+    if (rate != resampledRate) {
+        auto noSeek = -1.0;
+        seekTarget.compare_exchange_strong(noSeek, getCurrentPosition());
+    }
+
+    if (seekTarget.load() >= 0.0) {
+        const auto state = flushState.load(std::memory_order_acquire);
+
+        if (state == FlushIdle)
+            flushState.store(FlushRequested, std::memory_order_release);
+
+        if (state != FlushDone)
+            return 2;
+
+        const auto target = seekTarget.exchange(-1.0);
+
+        resampler->setResamplingRatio(sourceSampleRate / rate);
+        if (rate != resampledRate) {
+            resampler->prepareToPlay(chunkSamples, rate);
+            resampledRate = rate;
+        }
+
+        resampler->flushBuffers();
+        readerSource->setNextReadPosition(static_cast<juce::int64>(target * sourceSampleRate));
+        isSourceExhausted = false;
+        fifoStartSeconds = target;
+        flushState.store(FlushIdle, std::memory_order_release);
+    }
+
+    if (isSourceExhausted) {
+        // Playback stops once the audio thread has drained the end of the file
+        if (fifo.getNumReady() == 0 && playing.exchange(false))
+            sendChangeMessage();
+
+        return 20;
+    }
+
+    if (fifo.getFreeSpace() < chunkSamples)
+        return 5;
+
+    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+    fifo.prepareToWrite(chunkSamples, start1, size1, start2, size2);
+
+    if (size1 > 0)
+        resampler->getNextAudioBlock(juce::AudioSourceChannelInfo(&fifoBuffer, start1, size1));
+    if (size2 > 0)
+        resampler->getNextAudioBlock(juce::AudioSourceChannelInfo(&fifoBuffer, start2, size2));
+
+    fifo.finishedWrite(size1 + size2);
+    isSourceExhausted = readerSource->getNextReadPosition() >= readerSource->getTotalLength();
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "MultibandReverb/WaveformCache.h"
+
+//==============================================================================
+WaveformCache::WaveformCache() : juce::AudioThumbnailCache(maxThumbnailsInMemory) {
+    directory = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory).getChildFile("MultibandReverb").getChildFile("Waveforms");
+    formatManager.registerBasicFormats();
+}
+
+WaveformCache::~WaveformCache() = default;
+
+juce::File WaveformCache::getCacheFile(juce::int64 hashCode) const { return directory.getChildFile(juce::String::toHexString(hashCode) + ".thumb"); }
+
+void WaveformCache::saveNewlyFinishedThumbnail(const juce::AudioThumbnailBase &thumbnail, juce::int64 hashCode) {
+    if (!directory.createDirectory())
+        return;
+
+    // Write beside the target and swap it in, so a view loading the same file never reads half of it
+    juce::TemporaryFile temp(getCacheFile(hashCode));
+
+    if (auto out = temp.getFile().createOutputStream()) {
+        thumbnail.saveTo(*out);
+        out.reset();
+
+        if (temp.overwriteTargetFileWithTemporary())
+            pruneDirectory();
+    }
+}
+
+bool WaveformCache::loadNewThumb(juce::AudioThumbnailBase &thumbnail, juce::int64 hashCode) {
+    const auto file = getCacheFile(hashCode);
+
+    if (auto in = file.createInputStream(); in != nullptr && thumbnail.loadFrom(*in)) {
+        file.setLastAccessTime(juce::Time::getCurrentTime());
+        return true;
+    }
+
+    return false;
+}
+
+void WaveformCache::pruneDirectory() const {
+    auto files = directory.findChildFiles(juce::File::findFiles, false, "*.thumb");
+
+    if (files.size() <= maxThumbnailsOnDisk + pruneSlack)
+        return;
+
+    // Least recently used overviews go first
+    std::sort(files.begin(), files.end(), [](const juce::File &a, const juce::File &b) { return a.getLastAccessTime() < b.getLastAccessTime(); });
+
+    for (int i = 0; i < files.size() - maxThumbnailsOnDisk; ++i)
+        files.getReference(i).deleteFile();
+}
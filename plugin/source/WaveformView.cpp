@@ -0,0 +1,109 @@
+#include "MultibandReverb/WaveformView.h"
+
+//==============================================================================
+WaveformView::WaveformView(juce::Colour colour) : thumbnail(WaveformCache::samplesPerThumbnailSample, cache->getFormatManager(), *cache), waveformColour(colour) {
+    setOpaque(true);
+    thumbnail.addChangeListener(this);
+}
+
+WaveformView::~WaveformView() { thumbnail.removeChangeListener(this); }
+
+void WaveformView::setFile(const juce::File &file) {
+    // The hash covers the modification time, so an edited file is summarised again
+    thumbnail.setSource(new juce::FileInputSource(file, true));
+    renderedSamples = -1;
+    repaint();
+}
+
+void WaveformView::clear() {
+    thumbnail.clear();
+    renderedSamples = -1;
+    playhead = -1.0;
+    repaint();
+}
+
+void WaveformView::setPlayhead(double proportion) {
+    if (proportion == playhead)
+        return;
+
+    const auto oldArea = getPlayheadArea(playhead);
+    playhead = proportion;
+
+    if (oldArea.getX() != getPlayheadArea(playhead).getX()) {
+        repaint(oldArea);
+        repaint(getPlayheadArea(playhead));
+    }
+}
+
+juce::Rectangle<int> WaveformView::getPlayheadArea(double proportion) const {
+    if (proportion < 0.0)
+        return {};
+
+    const auto x = juce::roundToInt(juce::jlimit(0.0, 1.0, proportion) * getWidth());
+    return {x - 1, 0, 3, getHeight()};
+}
+
+void WaveformView::changeListenerCallback(juce::ChangeBroadcaster *) {
+    // The thumbnail reports each chunk it has read, draw whatever is new
+    if (thumbnail.getNumSamplesFinished() != renderedSamples)
+        repaint();
+}
+
+void WaveformView::resized() { renderedSamples = -1; }
+
+juce::Rectangle<int> WaveformView::getImageBounds(float scale) const { return {juce::jmax(1, juce::roundToInt(getWidth() * scale)), juce::jmax(1, juce::roundToInt(getHeight() * scale))}; }
+
+void WaveformView::renderWaveform(float scale) {
+    const auto bounds = getImageBounds(scale);
+
+    if (!waveformImage.isValid() || waveformImage.getBounds() != bounds)
+        waveformImage = juce::Image(juce::Image::ARGB, bounds.getWidth(), bounds.getHeight(), true);
+    else
+        waveformImage.clear(waveformImage.getBounds());
+
+    renderedSamples = thumbnail.getNumSamplesFinished();
+
+    if (thumbnail.getTotalLength() <= 0.0)
+        return;
+
+    // Laid out against the full length so the unread part stays blank until it arrives
+    juce::Graphics g(waveformImage);
+    g.setColour(waveformColour);
+    thumbnail.drawChannels(g, waveformImage.getBounds(), 0.0, thumbnail.getTotalLength(), 1.0f);
+}
+
+void WaveformView::paint(juce::Graphics &g) {
+    g.fillAll(juce::Colour(0xff1a1a1a));
+
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (renderedSamples != thumbnail.getNumSamplesFinished() || waveformImage.getBounds() != getImageBounds(scale))
+        renderWaveform(scale);
+
+    g.drawImage(waveformImage, getLocalBounds().toFloat());
+
+    if (thumbnail.getTotalLength() <= 0.0) {
+        g.setColour(juce::Colours::white.withAlpha(0.4f));
+        g.setFont(12.0f);
+        g.drawText("No file", getLocalBounds(), juce::Justification::centred);
+        return;
+    }
+
+    if (playhead >= 0.0) {
+        g.setColour(juce::Colours::white);
+        g.fillRect(getPlayheadArea(playhead).withTrimmedLeft(1).withWidth(1));
+    }
+}
+
+void WaveformView::mouseDown(const juce::MouseEvent &event) { scrubTo(event.position.x); }
+
+void WaveformView::mouseDrag(const juce::MouseEvent &event) { scrubTo(event.position.x); }
+
+void WaveformView::scrubTo(float x) {
+    if (onScrub == nullptr || thumbnail.getTotalLength() <= 0.0 || getWidth() <= 0)
+        return;
+
+    const auto proportion = juce::jlimit(0.0, 1.0, static_cast<double>(x) / getWidth());
+    setPlayhead(proportion);
+    onScrub(proportion);
+}
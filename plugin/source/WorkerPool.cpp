@@ -0,0 +1,82 @@
+#include "MultibandReverb/WorkerPool.h"
+#include "MultibandReverb/RealtimeSafety.h"
+
+//==============================================================================
+WorkerPool::~WorkerPool() {
+    for (auto &worker : workers)
+        worker->signalThreadShouldExit();
+
+    wake.release(static_cast<std::ptrdiff_t>(workers.size()));
+
+    for (auto &worker : workers)
+        worker->stopThread(1000);
+}
+
+void WorkerPool::reserve(size_t numWorkers) {
+    const juce::ScopedLock sl(startLock);
+
+    // More workers than spare cores would only compete with the hosts' audio threads
+    const auto numSpareCpus = static_cast<size_t>(juce::jmax(0, juce::SystemStats::getNumCpus() - 1));
+    numWorkers = juce::jmin(numWorkers, maxWorkers, numSpareCpus);
+
+    while (workers.size() < numWorkers) {
+        auto worker = std::make_unique<Worker>(*this);
+
+        // Realtime scheduling needs privileges on some systems, a high priority thread still helps
+        if (!worker->startRealtimeThread(juce::Thread::RealtimeOptions{}))
+            worker->startThread(juce::Thread::Priority::highest);
+
+        workers.push_back(std::move(worker));
+        numStarted.store(workers.size(), std::memory_order_release);
+    }
+}
+
+void WorkerPool::run(size_t numJobs, Job job) {
+    if (numJobs == 0)
+        return;
+
+    // Another instance has the workers, waiting for them would stall this audio thread
+    if (isBusy.exchange(true, std::memory_order_acquire)) {
+        for (size_t i = 0; i < numJobs; ++i)
+            job(i);
+        return;
+    }
+
+    currentJob = &job;
+    numPendingJobs = numJobs;
+    nextJob.store(0);
+
+    // Wake no more workers than there are jobs beyond the one this thread takes
+    const auto numHelpers = juce::jmin(getNumWorkers(), numJobs - 1);
+    wake.release(static_cast<std::ptrdiff_t>(numHelpers));
+
+    runPendingJobs();
+
+    for (size_t i = 0; i < numHelpers; ++i)
+        done.acquire();
+
+    currentJob = nullptr;
+    isBusy.store(false, std::memory_order_release);
+}
+
+void WorkerPool::runPendingJobs() {
+    for (auto index = nextJob.fetch_add(1); index < numPendingJobs; index = nextJob.fetch_add(1))
+        (*currentJob)(index);
+}
+
+void WorkerPool::Worker::run() {
+    while (!threadShouldExit()) {
+        pool.wake.acquire();
+
+        if (threadShouldExit())
+            break;
+
+        {
+            // Jobs are part of processBlock and held to the same rules
+            MBR_REALTIME_SECTION();
+            pool.runPendingJobs();
+        }
+
+        pool.done.release();
+    }
+}
@@ -0,0 +1,332 @@
+// RealtimeStressTest.cpp
+// Drives processBlock from a host audio thread while the message thread loads IRs, restores
+// sessions, toggles solo/mute, fits the FDN and starts, stops and seeks the transport, and another
+// thread automates every parameter. Runs a stereo and a 7.1.4 bus, the latter spreads its groups
+// over the reverb workers. Built with MBR_REALTIME_CHECKS=ON an allocation, lock or file access on
+// the audio thread or a worker aborts with a stack trace and fails the ctest run. Without the checks
+// it still fails on crashes and non-finite output. With the checks it first starts itself once per
+// kind of violation, takes an allocation or a lock inside a realtime section, the one processBlock
+// opens, and fails unless the child is aborted with a report.
+//
+// Usage: RealtimeStressTest [seconds per layout]
+#include "MultibandReverb/PluginProcessor.h"
+#include <JuceHeader.h>
+
+namespace {
+constexpr double sampleRate = 48000.0;
+constexpr int maxBlockSize = 512;
+constexpr int activityIntervalMs = 40;
+
+// Decaying stereo noise, stands in for both the IRs and the transport file
+juce::File writeNoiseFile(const juce::File &folder, const juce::String &name, double seconds, double decaySeconds) {
+    const auto file = folder.getChildFile(name);
+    const auto numSamples = static_cast<int>(seconds * sampleRate);
+    juce::AudioBuffer<float> buffer(2, numSamples);
+    juce::Random random(name.hashCode());
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        for (int i = 0; i < numSamples; ++i)
+            buffer.setSample(channel, i, (random.nextFloat() * 2.0f - 1.0f) * static_cast<float>(std::exp(-i / (decaySeconds * sampleRate))));
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+
+    if (auto out = file.createOutputStream()) {
+        writer.reset(wav.createWriterFor(out.get(), sampleRate, 2, 24, {}, 0));
+        if (writer != nullptr)
+            out.release();
+    }
+
+    if (writer == nullptr || !writer->writeFromAudioSampleBuffer(buffer, 0, numSamples))
+        return {};
+
+    return file;
+}
+
+// Calls processBlock back to back with a mix of block sizes, as a host would with varying buffers
+class HostThread : public juce::Thread {
+  public:
+    HostThread(MultibandReverbAudioProcessor &p, int numChannels) : juce::Thread("Host Audio"), processor(p), buffer(numChannels, maxBlockSize) {}
+
+    void run() override {
+        static constexpr int blockSizes[] = {maxBlockSize, 480, 256, 441, 64, 33, 1};
+        juce::Random random(1);
+        juce::MidiBuffer midi;
+
+        for (size_t block = 0; !threadShouldExit(); ++block) {
+            const auto numSamples = blockSizes[block % std::size(blockSizes)];
+            juce::AudioBuffer<float> hostBlock(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), numSamples);
+
+            for (int channel = 0; channel < hostBlock.getNumChannels(); ++channel)
+                for (int i = 0; i < numSamples; ++i)
+                    hostBlock.setSample(channel, i, random.nextFloat() * 0.5f - 0.25f);
+
+            processor.processBlock(hostBlock, midi);
+
+            for (int channel = 0; channel < hostBlock.getNumChannels(); ++channel) {
+                const auto range = juce::FloatVectorOperations::findMinAndMax(hostBlock.getReadPointer(channel), numSamples);
+                if (!std::isfinite(range.getStart()) || !std::isfinite(range.getEnd()))
+                    hasInvalidOutput = true;
+            }
+
+            ++numBlocks;
+        }
+    }
+
+    std::atomic<bool> hasInvalidOutput{false};
+    std::atomic<juce::int64> numBlocks{0};
+
+  private:
+    MultibandReverbAudioProcessor &processor;
+    juce::AudioBuffer<float> buffer;
+};
+
+// Sets random parameters to random values, hosts automate from threads of their own
+class AutomationThread : public juce::Thread {
+  public:
+    explicit AutomationThread(MultibandReverbAudioProcessor &p) : juce::Thread("Automation"), processor(p) {}
+
+    void run() override {
+        juce::Random random(2);
+        const auto &params = processor.getParameters();
+
+        while (!threadShouldExit()) {
+            if (auto *param = params[random.nextInt(params.size())])
+                param->setValueNotifyingHost(random.nextFloat());
+
+            wait(1);
+        }
+    }
+
+  private:
+    MultibandReverbAudioProcessor &processor;
+};
+
+class StressTest : private juce::Timer {
+  public:
+    StressTest(MultibandReverbAudioProcessor &p, const juce::File &folder, int secondsPerLayout) : processor(p), phaseLength(secondsPerLayout * 1000) {
+        irFiles = {writeNoiseFile(folder, "Short IR.wav", 1.5, 0.3), writeNoiseFile(folder, "Long IR.wav", 12.0, 2.5)};
+        transportFiles = {writeNoiseFile(folder, "Transport A.wav", 4.0, 100.0), writeNoiseFile(folder, "Transport B.wav", 2.0, 100.0)};
+        processor.addMeteringClient();
+    }
+
+    ~StressTest() override {
+        stopTimer();
+        stopThreads();
+        processor.removeMeteringClient();
+    }
+
+    bool hasTestFiles() const {
+        return std::all_of(irFiles.begin(), irFiles.end(), [](const auto &f) { return f.existsAsFile(); }) && std::all_of(transportFiles.begin(), transportFiles.end(), [](const auto &f) { return f.existsAsFile(); });
+    }
+
+    void start() {
+        nextLayout();
+        startTimer(activityIntervalMs);
+    }
+
+    bool hasPassed() const { return !hasFailed && numLayoutsRun == std::size(layouts); }
+
+  private:
+    void timerCallback() override {
+        if (juce::Time::getMillisecondCounter() >= phaseEnd) {
+            nextLayout();
+            return;
+        }
+
+        const auto band = static_cast<size_t>(random.nextInt(3));
+
+        switch (random.nextInt(8)) {
+        case 0:
+            processor.loadImpulseResponse(band, irFiles[static_cast<size_t>(random.nextInt(2))]);
+            break;
+        case 1:
+            processor.bandReverbs[band].isSoloed = random.nextBool();
+            processor.updateSoloMuteStates();
+            break;
+        case 2:
+            processor.bandReverbs[band].isMuted = random.nextBool();
+            processor.updateSoloMuteStates();
+            break;
+        case 3:
+            processor.transport.loadFile(transportFiles[static_cast<size_t>(random.nextInt(2))]);
+            break;
+        case 4:
+            if (processor.transport.isPlaying())
+                processor.transport.stop();
+            else
+                processor.transport.start();
+            break;
+        case 5:
+            processor.transport.setPosition(random.nextDouble() * processor.transport.getLengthInSeconds());
+            break;
+        case 6: {
+            juce::MemoryBlock state;
+            processor.getStateInformation(state);
+            processor.setStateInformation(state.getData(), static_cast<int>(state.getSize()));
+            break;
+        }
+        default:
+            processor.fitFdnToImpulseResponse(band);
+            break;
+        }
+    }
+
+    void nextLayout() {
+        stopThreads();
+
+        if (host != nullptr) {
+            const auto failed = host->hasInvalidOutput.load();
+            std::printf("%s: %lld blocks%s\n", layouts[numLayoutsRun].getDescription().toRawUTF8(), static_cast<long long>(host->numBlocks.load()), failed ? ", non-finite output" : "");
+            hasFailed = hasFailed || failed || host->numBlocks.load() == 0;
+            ++numLayoutsRun;
+        }
+
+        if (numLayoutsRun == std::size(layouts)) {
+            stopTimer();
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+            return;
+        }
+
+        // Hosts only change the layout while stopped, then prepare again
+        const auto layout = layouts[numLayoutsRun];
+        processor.releaseResources();
+
+        juce::AudioProcessor::BusesLayout busesLayout;
+        busesLayout.inputBuses.add(layout);
+        busesLayout.outputBuses.add(layout);
+
+        if (!processor.setBusesLayout(busesLayout)) {
+            std::printf("%s: layout rejected\n", layout.getDescription().toRawUTF8());
+            hasFailed = true;
+            stopTimer();
+            juce::MessageManager::getInstance()->stopDispatchLoop();
+            return;
+        }
+
+        processor.setRateAndBufferSizeDetails(sampleRate, maxBlockSize);
+        processor.prepareToPlay(sampleRate, maxBlockSize);
+
+        host = std::make_unique<HostThread>(processor, layout.size());
+        automation = std::make_unique<AutomationThread>(processor);
+        host->startThread(juce::Thread::Priority::highest);
+        automation->startThread();
+
+        phaseEnd = juce::Time::getMillisecondCounter() + static_cast<juce::uint32>(phaseLength);
+    }
+
+    void stopThreads() {
+        for (auto *thread : {static_cast<juce::Thread *>(host.get()), static_cast<juce::Thread *>(automation.get())})
+            if (thread != nullptr)
+                thread->stopThread(10000);
+    }
+
+    MultibandReverbAudioProcessor &processor;
+    const int phaseLength;
+    const juce::AudioChannelSet layouts[2]{juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create7point1point4()};
+    size_t numLayoutsRun = 0;
+    juce::uint32 phaseEnd = 0;
+    bool hasFailed = false;
+
+    std::array<juce::File, 2> irFiles;
+    std::array<juce::File, 2> transportFiles;
+    juce::Random random{3};
+
+    std::unique_ptr<HostThread> host;
+    std::unique_ptr<AutomationThread> automation;
+};
+
+#if MBR_REALTIME_CHECKS
+constexpr const char *violateArgument = "--violate";
+
+// Escapes the allocation so the compiler can't pair it with its delete and drop both
+void *volatile allocationSink = nullptr;
+
+// Child side: commits one violation inside a realtime section, returning means it went unreported
+int violate(const juce::String &kind) {
+    std::mutex mutex;
+
+    {
+        MBR_REALTIME_SECTION();
+
+        if (kind == "allocation") {
+            allocationSink = new char[64];
+            delete[] static_cast<char *>(allocationSink);
+        } else if (kind == "lock") {
+            const std::lock_guard lock(mutex);
+        }
+    }
+
+    return 0;
+}
+
+// Whether each kind of violation aborts a child process with a report. Locks are only trapped
+// where pthread_mutex_lock is interposed.
+bool checkViolationsReported() {
+    const auto executable = juce::File::getSpecialLocation(juce::File::currentExecutableFile).getFullPathName();
+    juce::StringArray kinds{"allocation"};
+#if MBR_REALTIME_INTERPOSE_LIBC
+    kinds.add("lock");
+#endif
+
+    bool passed = true;
+
+    for (const auto &kind : kinds) {
+        juce::ChildProcess child;
+        bool isReported = false;
+
+        if (child.start(juce::StringArray{executable, violateArgument, kind}, juce::ChildProcess::wantStdOut | juce::ChildProcess::wantStdErr)) {
+            const auto output = child.readAllProcessOutput();
+            isReported = child.waitForProcessToFinish(10000) && child.getExitCode() != 0 && output.contains("Realtime violation");
+        }
+
+        std::printf("Realtime %s %s\n", kind.toRawUTF8(), isReported ? "reported" : "not reported");
+        passed = passed && isReported;
+    }
+
+    return passed;
+}
+#endif
+} // namespace
+
+//==============================================================================
+int main(int argc, char *argv[]) {
+#if MBR_REALTIME_CHECKS
+    if (argc > 2 && juce::String(argv[1]) == violateArgument)
+        return violate(argv[2]);
+#endif
+
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    const auto secondsPerLayout = argc > 1 ? juce::jmax(1, juce::String(argv[1]).getIntValue()) : 10;
+
+#if MBR_REALTIME_CHECKS
+    if (!checkViolationsReported()) {
+        std::printf("Failed\n");
+        return 1;
+    }
+#else
+    std::printf("Built without MBR_REALTIME_CHECKS, realtime violations are not trapped\n");
+#endif
+
+    const auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory).getNonexistentChildFile("MultibandReverbStress", {});
+    folder.createDirectory();
+
+    bool passed = false;
+
+    {
+        MultibandReverbAudioProcessor processor;
+        StressTest test(processor, folder, secondsPerLayout);
+
+        if (test.hasTestFiles()) {
+            test.start();
+            juce::MessageManager::getInstance()->runDispatchLoop();
+            passed = test.hasPassed();
+        } else {
+            std::printf("Couldn't write the test files to %s\n", folder.getFullPathName().toRawUTF8());
+        }
+    }
+
+    folder.deleteRecursively();
+    std::printf("%s\n", passed ? "Passed" : "Failed");
+    return passed ? 0 : 1;
+}
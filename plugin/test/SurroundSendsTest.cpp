@@ -0,0 +1,119 @@
+// SurroundSendsTest.cpp
+// Runs noise through a 5.1 bus with the FDN on every band and checks that each channel outside
+// the reverb sends, LFE under every ReverbSends choice and the surrounds under Front Only and
+// First Pair, comes out at the level it went in. Those channels get no wet signal back, so their
+// dry bands must not make way for one.
+//
+// Usage: SurroundSendsTest
+#include "MultibandReverb/PluginProcessor.h"
+#include <JuceHeader.h>
+
+namespace {
+constexpr double sampleRate = 48000.0;
+constexpr int blockSize = 512;
+constexpr int settleBlocks = 94;  // About a second for the crossovers and engines to settle
+constexpr int measureBlocks = 94; // Then about a second measured
+constexpr float toleranceDb = 0.5f;
+
+void setChoice(MultibandReverbAudioProcessor &processor, const juce::String &parameterID, int index) {
+    auto *param = processor.parameters.getParameter(parameterID);
+    param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(index)));
+}
+
+bool isSend(juce::AudioChannelSet::ChannelType type, int channel, MultibandReverbAudioProcessor::ReverbSends sends) {
+    using Sends = MultibandReverbAudioProcessor::ReverbSends;
+
+    switch (sends) {
+    case Sends::All:
+        return type != juce::AudioChannelSet::LFE && type != juce::AudioChannelSet::LFE2;
+    case Sends::FrontOnly:
+        return type == juce::AudioChannelSet::left || type == juce::AudioChannelSet::right || type == juce::AudioChannelSet::centre;
+    case Sends::FirstPair:
+        return channel < 2;
+    }
+
+    return false;
+}
+
+// Whether every channel outside the sends comes out at its input level
+bool runSends(MultibandReverbAudioProcessor::ReverbSends sends, const char *name) {
+    const auto layout = juce::AudioChannelSet::create5point1();
+    MultibandReverbAudioProcessor processor;
+
+    juce::AudioProcessor::BusesLayout busesLayout;
+    busesLayout.inputBuses.add(layout);
+    busesLayout.outputBuses.add(layout);
+
+    if (!processor.setBusesLayout(busesLayout)) {
+        std::printf("5.1 layout rejected\n");
+        return false;
+    }
+
+    for (size_t band = 0; band < 3; ++band)
+        setChoice(processor, MultibandReverbAudioProcessor::getBandParameterID(band, "Engine"), static_cast<int>(MultibandReverbAudioProcessor::ReverbEngine::Fdn));
+
+    setChoice(processor, "reverbSends", static_cast<int>(sends));
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+
+    const auto numChannels = layout.size();
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    std::vector<double> inputEnergy(static_cast<size_t>(numChannels)), outputEnergy(static_cast<size_t>(numChannels));
+    juce::Random random(1);
+    juce::MidiBuffer midi;
+
+    for (int block = 0; block < settleBlocks + measureBlocks; ++block) {
+        const bool isMeasured = block >= settleBlocks;
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+            for (int i = 0; i < blockSize; ++i) {
+                const auto sample = random.nextFloat() * 0.5f - 0.25f;
+                buffer.setSample(channel, i, sample);
+                if (isMeasured)
+                    inputEnergy[static_cast<size_t>(channel)] += sample * sample;
+            }
+        }
+
+        processor.processBlock(buffer, midi);
+
+        if (isMeasured)
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int i = 0; i < blockSize; ++i)
+                    outputEnergy[static_cast<size_t>(channel)] += buffer.getSample(channel, i) * buffer.getSample(channel, i);
+    }
+
+    processor.releaseResources();
+
+    bool passed = true;
+
+    for (int channel = 0; channel < numChannels; ++channel) {
+        const auto type = layout.getTypeOfChannel(channel);
+        if (isSend(type, channel, sends))
+            continue;
+
+        const auto index = static_cast<size_t>(channel);
+        const auto changeDb = static_cast<float>(10.0 * std::log10(juce::jmax(1.0e-12, outputEnergy[index]) / juce::jmax(1.0e-12, inputEnergy[index])));
+        const bool isUnchanged = std::abs(changeDb) <= toleranceDb;
+        std::printf("%s, %s: %+.2f dB%s\n", name, juce::AudioChannelSet::getAbbreviatedChannelTypeName(type).toRawUTF8(), changeDb, isUnchanged ? "" : ", level changed");
+        passed = passed && isUnchanged;
+    }
+
+    return passed;
+}
+} // namespace
+
+//==============================================================================
+int main() {
+    const juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    using Sends = MultibandReverbAudioProcessor::ReverbSends;
+
+    // Every choice is run, a failure in one doesn't hide the others
+    const auto all = runSends(Sends::All, "All Channels");
+    const auto frontOnly = runSends(Sends::FrontOnly, "Front Only");
+    const auto firstPair = runSends(Sends::FirstPair, "First Pair");
+    const auto passed = all && frontOnly && firstPair;
+
+    std::printf("%s\n", passed ? "Passed" : "Failed");
+    return passed ? 0 : 1;
+}